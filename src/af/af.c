@@ -21,11 +21,62 @@
 #include <math.h>
 #include <inttypes.h>
 #include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include "af.h"
 #include "../bitset/bitset.h"
 #include "../utils/timer.h"
 
+extern inline char check_set_attacks_arg(AF* af, BitSet* s, int arg);
+extern inline char check_set_defends_arg(AF* af, BitSet* s, int arg);
+extern inline char is_set_conflict_free(AF* af, BitSet* s);
+extern inline SIZE_TYPE find_argument_root(SIZE_TYPE* parent, SIZE_TYPE i);
+extern inline void union_arguments(SIZE_TYPE* parent, SIZE_TYPE i, SIZE_TYPE j);
+
+// Alignment of the rows of the adjacency matrix
+#define AF_CACHE_LINE_SIZE	64
+// Adjacency matrices of at least this size are aligned to huge pages
+#define AF_HUGE_PAGE_SIZE	(2 * 1024 * 1024)
+
+// Number of base elements between the starts of two rows. Short rows are
+// padded to a power of two, long ones to a multiple of the cache line, so
+// that no row straddles more cache lines than necessary.
+static SIZE_TYPE get_row_stride(SIZE_TYPE base_count) {
+	SIZE_TYPE line = AF_CACHE_LINE_SIZE / sizeof(BITSET_BASE_TYPE);
+	if (base_count >= line)
+		return((base_count + line - 1) / line * line);
+
+	SIZE_TYPE stride = 1;
+	while (stride < base_count)
+		stride *= 2;
+	return(stride);
+}
+
+// Allocate the zeroed slab for the rows. Large slabs are aligned to huge
+// pages and the kernel is asked to back them with transparent huge pages.
+static BITSET_BASE_TYPE* allocate_matrix(size_t bytes) {
+	size_t alignment = AF_CACHE_LINE_SIZE;
+	if (bytes >= AF_HUGE_PAGE_SIZE) {
+		alignment = AF_HUGE_PAGE_SIZE;
+		bytes = (bytes + AF_HUGE_PAGE_SIZE - 1) / AF_HUGE_PAGE_SIZE * AF_HUGE_PAGE_SIZE;
+	} else if (bytes == 0) {
+		bytes = AF_CACHE_LINE_SIZE;
+	}
+
+	void* matrix = NULL;
+	int err = posix_memalign(&matrix, alignment, bytes);
+	assert(err == 0 && matrix != NULL);
+#ifdef MADV_HUGEPAGE
+	if (alignment == AF_HUGE_PAGE_SIZE)
+		madvise(matrix, bytes, MADV_HUGEPAGE);
+#endif
+	memset(matrix, 0, bytes);
+
+	return((BITSET_BASE_TYPE*) matrix);
+}
+
 AF* create_argumentation_framework(SIZE_TYPE size) {
 	AF *af = calloc(1, sizeof(AF));
 	assert(af != NULL);
@@ -35,20 +86,96 @@ AF* create_argumentation_framework(SIZE_TYPE size) {
 	af->graph = (BitSet**) calloc(size, sizeof(BitSet*));
 	assert(af->graph != NULL);
 
-	int i;
-	for (i = 0; i < size; ++i) {
-		af->graph[i] = create_bitset(size);
+	af->rows = (BitSet*) calloc(size, sizeof(BitSet));
+	assert(size == 0 || af->rows != NULL);
+
+	SIZE_TYPE base_count = (size + BITSET_BASE_SIZE - 1) / BITSET_BASE_SIZE;
+	af->row_stride = get_row_stride(base_count);
+	af->matrix = allocate_matrix((size_t) size * af->row_stride * sizeof(BITSET_BASE_TYPE));
+
+	for (SIZE_TYPE i = 0; i < size; ++i) {
+		af->rows[i].size = size;
+		af->rows[i].base_count = base_count;
+		af->rows[i].elements = AF_ROW(af, i);
+		af->graph[i] = &(af->rows[i]);
 	}
 
+	return(af);
+}
+
+AF* create_sparse_argumentation_framework(SIZE_TYPE size, SIZE_TYPE* victim_counts) {
+	AF *af = calloc(1, sizeof(AF));
+	assert(af != NULL);
+
+	af->size = size;
+
+	af->sparse_graph = (HybridSet**) calloc(size > 0 ? size : 1, sizeof(HybridSet*));
+	assert(af->sparse_graph != NULL);
+
+	for (SIZE_TYPE i = 0; i < size; ++i)
+		af->sparse_graph[i] = create_hybrid_set(size, victim_counts[i]);
 
 	return(af);
 }
 
-int free_argumentation_framework(AF* af) {
-	int freed_bytes = 0;
-	for (SIZE_TYPE i = 0; i < af->size; ++i) {
-		freed_bytes += free_bitset(af->graph[i]);
+AF* dense_argumentation_framework(AF* af) {
+	AF* d_af = create_argumentation_framework(af->size);
+
+	for (SIZE_TYPE i = 0; i < af->size; ++i)
+		hybrid_set_union_into(af->sparse_graph[i], d_af->graph[i]);
+
+	return(d_af);
+}
+
+// Bytes of the victim and attacker lists (see set_adjacency_lists) and the
+// weak components, read_af builds them for both storages
+static size_t adjacency_list_bytes(SIZE_TYPE size, size_t att_count) {
+	return(2 * ((size_t) size + 1) * sizeof(size_t) + 2 * att_count * sizeof(SIZE_TYPE) + (size_t) size * sizeof(SIZE_TYPE));
+}
+
+size_t dense_af_bytes(SIZE_TYPE size, size_t att_count) {
+	size_t base_count = (size + BITSET_BASE_SIZE - 1) / BITSET_BASE_SIZE;
+	size_t row_bytes = get_row_stride(base_count) * sizeof(BITSET_BASE_TYPE) + sizeof(BitSet) + sizeof(BitSet*);
+	return(AF_DENSE_MATRIX_COPIES * size * row_bytes + adjacency_list_bytes(size, att_count));
+}
+
+size_t sparse_af_bytes(SIZE_TYPE size, size_t att_count) {
+	return((size_t) size * (sizeof(HybridSet) + sizeof(HybridSet*)) + att_count * sizeof(SIZE_TYPE) + adjacency_list_bytes(size, att_count));
+}
+
+enum af_storage plan_af_storage(SIZE_TYPE size, size_t att_count, size_t memory_budget) {
+	size_t dense_bytes = dense_af_bytes(size, att_count);
+	// sparse rows are only worth it if they are smaller, a framework that
+	// has too many attacks for them runs out of memory either way
+	if (memory_budget == 0 || dense_bytes <= memory_budget || dense_bytes <= sparse_af_bytes(size, att_count))
+		return(AF_STORAGE_DENSE);
+	return(AF_STORAGE_SPARSE);
+}
+
+size_t default_memory_budget() {
+	long pages = sysconf(_SC_PHYS_PAGES);
+	long page_size = sysconf(_SC_PAGE_SIZE);
+	if (pages <= 0 || page_size <= 0)
+		return(0);
+	return((size_t) pages * page_size / 2);
+}
+
+size_t free_argumentation_framework(AF* af) {
+	drop_derived_data(af);
+	if (IS_SPARSE_AF(af)) {
+		size_t freed_bytes = 0;
+		for (SIZE_TYPE i = 0; i < af->size; ++i)
+			freed_bytes += free_hybrid_set(af->sparse_graph[i]);
+		free(af->sparse_graph);
+		freed_bytes += af->size * sizeof(HybridSet*);
+		free(af);
+		return(freed_bytes + sizeof(AF));
 	}
+
+	size_t freed_bytes = (size_t) af->size * af->row_stride * sizeof(BITSET_BASE_TYPE);
+	free(af->matrix);
+	free(af->rows);
+	freed_bytes += (af->size * sizeof(BitSet));
 	free(af->graph);
 	freed_bytes += (af->size * sizeof(BitSet*));
 	free(af);
@@ -57,6 +184,220 @@ int free_argumentation_framework(AF* af) {
 }
 
 
+// Counting sort of the lists by their targets: t_indices[t_offsets[j]] ...
+// are the i with j in the list of i, in increasing order.
+static void transpose_adjacency_lists(SIZE_TYPE size, size_t* offsets, SIZE_TYPE* indices,
+									  size_t** t_offsets, SIZE_TYPE** t_indices) {
+	size_t count = offsets[size];
+	*t_offsets = (size_t*) calloc(size + 1, sizeof(size_t));
+	assert(*t_offsets != NULL);
+	*t_indices = (SIZE_TYPE*) malloc((count > 0 ? count : 1) * sizeof(SIZE_TYPE));
+	assert(*t_indices != NULL);
+
+	for (size_t k = 0; k < count; ++k)
+		++(*t_offsets)[indices[k] + 1];
+	for (SIZE_TYPE j = 0; j < size; ++j)
+		(*t_offsets)[j + 1] += (*t_offsets)[j];
+
+	size_t* next = (size_t*) malloc((size > 0 ? size : 1) * sizeof(size_t));
+	assert(next != NULL);
+	memcpy(next, *t_offsets, size * sizeof(size_t));
+	for (SIZE_TYPE i = 0; i < size; ++i)
+		for (size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+			(*t_indices)[next[indices[k]]++] = i;
+	free(next);
+}
+
+void set_adjacency_lists(AF* af, SIZE_TYPE* attacks, size_t att_count) {
+	free_adjacency_lists(af);
+
+	// group the attackers by victim, then transpose to get the victim lists sorted
+	size_t* offsets = (size_t*) calloc(af->size + 1, sizeof(size_t));
+	assert(offsets != NULL);
+	SIZE_TYPE* indices = (SIZE_TYPE*) malloc((att_count > 0 ? att_count : 1) * sizeof(SIZE_TYPE));
+	assert(indices != NULL);
+	for (size_t k = 0; k < att_count; ++k)
+		++offsets[attacks[2 * k + 1] + 1];
+	for (SIZE_TYPE j = 0; j < af->size; ++j)
+		offsets[j + 1] += offsets[j];
+	for (size_t k = 0; k < att_count; ++k)
+		indices[--offsets[attacks[2 * k + 1] + 1]] = attacks[2 * k];
+	// the decrements moved offsets[j + 1] back to the start of list j
+	for (SIZE_TYPE j = 0; j < af->size; ++j)
+		offsets[j] = offsets[j + 1];
+	offsets[af->size] = att_count;
+
+	transpose_adjacency_lists(af->size, offsets, indices, &af->victim_offsets, &af->victims);
+	free(offsets);
+	free(indices);
+
+	// drop the duplicates, the lists are sorted
+	size_t w = 0;
+	for (SIZE_TYPE i = 0; i < af->size; ++i) {
+		size_t begin = af->victim_offsets[i], end = af->victim_offsets[i + 1];
+		af->victim_offsets[i] = w;
+		for (size_t k = begin; k < end; ++k)
+			if (k == begin || af->victims[k] != af->victims[k - 1])
+				af->victims[w++] = af->victims[k];
+	}
+	af->victim_offsets[af->size] = w;
+
+	transpose_adjacency_lists(af->size, af->victim_offsets, af->victims, &af->attacker_offsets, &af->attackers);
+}
+
+void build_adjacency_lists(AF* af) {
+	if (HAS_ADJACENCY_LISTS(af))
+		return;
+
+	af->victim_offsets = (size_t*) calloc(af->size + 1, sizeof(size_t));
+	assert(af->victim_offsets != NULL);
+	for (SIZE_TYPE i = 0; i < af->size; ++i)
+		af->victim_offsets[i + 1] = af->victim_offsets[i] +
+			(IS_SPARSE_AF(af) ? af->sparse_graph[i]->count : count_bits(af->graph[i]));
+
+	size_t count = af->victim_offsets[af->size];
+	af->victims = (SIZE_TYPE*) malloc((count > 0 ? count : 1) * sizeof(SIZE_TYPE));
+	assert(af->victims != NULL);
+	size_t k = 0;
+	for (SIZE_TYPE i = 0; i < af->size; ++i) {
+		SIZE_TYPE j;
+		if (IS_SPARSE_AF(af)) {
+			FOR_EACH_HYBRID_SET_ELEMENT(af->sparse_graph[i], j)
+				af->victims[k++] = j;
+		} else {
+			FOR_EACH_SET_BIT(af->graph[i], j)
+				af->victims[k++] = j;
+		}
+	}
+
+	transpose_adjacency_lists(af->size, af->victim_offsets, af->victims, &af->attacker_offsets, &af->attackers);
+}
+
+void free_adjacency_lists(AF* af) {
+	free(af->victim_offsets);
+	free(af->victims);
+	free(af->attacker_offsets);
+	free(af->attackers);
+	af->victim_offsets = af->attacker_offsets = NULL;
+	af->victims = af->attackers = NULL;
+}
+
+void set_weak_components(AF* af, SIZE_TYPE* parent) {
+	free(af->component_of);
+	// the parent of i is smaller than i, its root is already in place
+	af->component_count = 0;
+	for (SIZE_TYPE i = 0; i < af->size; ++i)
+		if (parent[i] == i)
+			++af->component_count;
+		else
+			parent[i] = parent[parent[i]];
+	af->component_of = parent;
+}
+
+void build_weak_components(AF* af) {
+	if (af->component_of)
+		return;
+
+	SIZE_TYPE* parent = (SIZE_TYPE*) malloc((af->size > 0 ? af->size : 1) * sizeof(SIZE_TYPE));
+	assert(parent != NULL);
+	for (SIZE_TYPE i = 0; i < af->size; ++i)
+		parent[i] = i;
+	SIZE_TYPE j;
+	for (SIZE_TYPE i = 0; i < af->size; ++i) {
+		if (HAS_ADJACENCY_LISTS(af)) {
+			FOR_EACH_VICTIM(af, i, j)
+				union_arguments(parent, i, j);
+		} else if (IS_SPARSE_AF(af)) {
+			FOR_EACH_HYBRID_SET_ELEMENT(af->sparse_graph[i], j)
+				union_arguments(parent, i, j);
+		} else {
+			FOR_EACH_SET_BIT(af->graph[i], j)
+				union_arguments(parent, i, j);
+		}
+	}
+	set_weak_components(af, parent);
+}
+
+
+struct af_cache_stats af_cache_stats;
+
+static size_t af_cache_limit = 0;
+
+void set_af_cache_limit(size_t limit) {
+	af_cache_limit = limit;
+}
+
+// Bytes of a dense framework
+static size_t framework_bytes(AF* af) {
+	size_t bytes = sizeof(AF) + (size_t) af->size * (af->row_stride * sizeof(BITSET_BASE_TYPE) + sizeof(BitSet) + sizeof(BitSet*));
+	if (HAS_ADJACENCY_LISTS(af))
+		bytes += 2 * ((af->size + 1) * sizeof(size_t) + af->victim_offsets[af->size] * sizeof(SIZE_TYPE));
+	return(bytes);
+}
+
+static AF* get_derived_framework(AF* af, AF** derived, AF* (*create)(AF*)) {
+	if (*derived) {
+		++af_cache_stats.reused;
+	} else {
+		*derived = create(af);
+		(*derived)->derived_from = af;
+		++af_cache_stats.built;
+		af_cache_stats.bytes += framework_bytes(*derived);
+		if (af_cache_stats.bytes > af_cache_stats.peak_bytes)
+			af_cache_stats.peak_bytes = af_cache_stats.bytes;
+	}
+	++(*derived)->ref_count;
+	return(*derived);
+}
+
+static void free_derived_framework(AF** derived) {
+	if (*derived == NULL)
+		return;
+	// nobody may hold it any more
+	assert((*derived)->ref_count == 0);
+	af_cache_stats.bytes -= framework_bytes(*derived);
+	free_argumentation_framework(*derived);
+	*derived = NULL;
+}
+
+AF* get_complement_framework(AF* af) {
+	return(get_derived_framework(af, &af->complement, complement_argumentation_framework));
+}
+
+AF* get_transpose_framework(AF* af) {
+	return(get_derived_framework(af, &af->transpose, transpose_argumentation_framework));
+}
+
+AF* get_conflict_framework(AF* af) {
+	return(get_derived_framework(af, &af->conflicts, create_conflict_framework));
+}
+
+void release_derived_framework(AF* derived) {
+	assert(derived->ref_count > 0);
+	--derived->ref_count;
+	if (derived->ref_count > 0 || af_cache_limit == 0 || af_cache_stats.bytes <= af_cache_limit)
+		return;
+
+	AF* af = derived->derived_from;
+	if (af->complement == derived)
+		free_derived_framework(&af->complement);
+	else if (af->transpose == derived)
+		free_derived_framework(&af->transpose);
+	else
+		free_derived_framework(&af->conflicts);
+	++af_cache_stats.evicted;
+}
+
+void drop_derived_data(AF* af) {
+	free_adjacency_lists(af);
+	free(af->component_of);
+	af->component_of = NULL;
+	free_derived_framework(&af->complement);
+	free_derived_framework(&af->transpose);
+	free_derived_framework(&af->conflicts);
+}
+
+
 void free_paf(PAF* paf, bool free_af) {
 	free(paf->base_mapping);
 	free(paf->parent_mapping);
@@ -89,6 +430,34 @@ AF* complement_argumentation_framework(AF *af ){
 	return(c_af);
 }
 
+// Transpose the matrix of af into the rows of t_af. The 64x64 blocks of a
+// strip of 64 rows are transposed together, block b of strip s gives word s
+// of the rows 64b, ..., 64b + 63 of t_af. The strips are done a cache line
+// of words at a time, so that each row of t_af is written in one piece.
+static void transpose_matrix(AF* af, AF* t_af) {
+	if (af->size == 0)
+		return;
+	SIZE_TYPE base_count = af->graph[0]->base_count;
+	SIZE_TYPE line = AF_CACHE_LINE_SIZE / sizeof(BITSET_BASE_TYPE);
+	size_t strip_size = (size_t) base_count * BITSET_BASE_SIZE;
+	BITSET_BASE_TYPE* strips = (BITSET_BASE_TYPE*) malloc(line * strip_size * sizeof(BITSET_BASE_TYPE));
+	assert(strips != NULL);
+	for (SIZE_TYPE first_strip = 0; first_strip < base_count; first_strip += line) {
+		SIZE_TYPE strip_count = base_count - first_strip < line ? base_count - first_strip : line;
+		for (SIZE_TYPE s = 0; s < strip_count; ++s) {
+			SIZE_TYPE first = (first_strip + s) * BITSET_BASE_SIZE;
+			SIZE_TYPE rows = af->size - first < BITSET_BASE_SIZE ? af->size - first : BITSET_BASE_SIZE;
+			bitset_kernels.transpose_blocks(AF_ROW(af, first), af->row_stride, rows, strips + s * strip_size, base_count);
+		}
+		for (SIZE_TYPE j = 0; j < af->size; ++j) {
+			BITSET_BASE_TYPE* row = AF_ROW(t_af, j) + first_strip;
+			for (SIZE_TYPE s = 0; s < strip_count; ++s)
+				row[s] = strips[s * strip_size + j];
+		}
+	}
+	free(strips);
+}
+
 AF* transpose_argumentation_framework(AF *af) {
 	struct timeval start_time, stop_time;
 	START_TIMER(start_time);
@@ -96,10 +465,20 @@ AF* transpose_argumentation_framework(AF *af) {
 
 	t_af->size = af->size;
 
-	for (SIZE_TYPE i = 0; i < af->size; ++i)
-		for (SIZE_TYPE j = 0; j < af->size; ++j)
-			if (TEST_BIT(af->graph[i], j))
-				SET_BIT(t_af->graph[j], i);
+	transpose_matrix(af, t_af);
+	if (HAS_ADJACENCY_LISTS(af)) {
+		// the attacker lists are the victim lists of the transpose
+		size_t count = af->victim_offsets[af->size];
+		t_af->victim_offsets = (size_t*) malloc((af->size + 1) * sizeof(size_t));
+		t_af->victims = (SIZE_TYPE*) malloc((count > 0 ? count : 1) * sizeof(SIZE_TYPE));
+		t_af->attacker_offsets = (size_t*) malloc((af->size + 1) * sizeof(size_t));
+		t_af->attackers = (SIZE_TYPE*) malloc((count > 0 ? count : 1) * sizeof(SIZE_TYPE));
+		assert(t_af->victim_offsets != NULL && t_af->victims != NULL && t_af->attacker_offsets != NULL && t_af->attackers != NULL);
+		memcpy(t_af->victim_offsets, af->attacker_offsets, (af->size + 1) * sizeof(size_t));
+		memcpy(t_af->victims, af->attackers, count * sizeof(SIZE_TYPE));
+		memcpy(t_af->attacker_offsets, af->victim_offsets, (af->size + 1) * sizeof(size_t));
+		memcpy(t_af->attackers, af->victims, count * sizeof(SIZE_TYPE));
+	}
 	STOP_TIMER(stop_time);
 	printf("Transposing AF time: %.3f milisecs\n", TIME_DIFF(start_time, stop_time) / 1000);
 	return(t_af);
@@ -111,19 +490,416 @@ AF* create_conflict_framework(AF* af) {
 
 	conflicts->size = af->size;
 
+	// i and j conflict if one attacks the other or one of them attacks itself
+	BitSet* loops = create_bitset(af->size);
+	for (SIZE_TYPE i = 0; i < af->size; ++i)
+		if (TEST_BIT(af->graph[i], i))
+			SET_BIT(loops, i);
+
+	transpose_matrix(af, conflicts);
 	for (SIZE_TYPE i = 0; i < af->size; ++i) {
-		bool iconflict = TEST_BIT(af->graph[i], i);
-		for (SIZE_TYPE j = i; j < af->size; ++j) {
-			if (iconflict || TEST_BIT(af->graph[i], j) || TEST_BIT(af->graph[j], i) || TEST_BIT(af->graph[j], j)) {
-				SET_BIT(conflicts->graph[i], j);
-				SET_BIT(conflicts->graph[j], i);
-			}
+		if (TEST_BIT(loops, i)) {
+			set_bitset(conflicts->graph[i]);
+			continue;
 		}
+		bitset_union(conflicts->graph[i], af->graph[i], conflicts->graph[i]);
+		bitset_union(conflicts->graph[i], loops, conflicts->graph[i]);
 	}
+	free_bitset(loops);
 
 	return conflicts;
 }
 
+// Number of words of the result rows computed together by boolean_product
+#define AF_PRODUCT_TILE_WORDS	(AF_CACHE_LINE_SIZE / sizeof(BITSET_BASE_TYPE))
+// Number of rows of b combined in one table of boolean_product
+#define AF_PRODUCT_TABLE_BITS	8
+#define AF_PRODUCT_TABLE_SIZE	(1 << AF_PRODUCT_TABLE_BITS)
+#define AF_PRODUCT_TABLE_COUNT	(BITSET_BASE_SIZE / AF_PRODUCT_TABLE_BITS)
+
+// Boolean product in the Four Russians style: row i of r is the union of
+// the rows k of b for the k in row i of a. The rows of b are taken in
+// groups of 8, and the 256 unions of the rows of a group are tabulated, each
+// from a smaller one and a single row. A row of a then adds the union for
+// one of its bytes with one lookup. The words of a are done a column at a
+// time: the rows with a nonzero word are gathered first, and the tables are
+// only built for the bytes that occur. The columns of r are done a cache
+// line at a time, so that the tables for the 64 rows of b behind a word of
+// a fit into the L2 cache.
+static void boolean_product(AF* a, AF* b, AF* r) {
+	assert(!IS_SPARSE_AF(a) && !IS_SPARSE_AF(b) && a->size == b->size && a->size == r->size);
+	if (a->size == 0)
+		return;
+	SIZE_TYPE base_count = a->graph[0]->base_count;
+	BITSET_BASE_TYPE* tables = (BITSET_BASE_TYPE*) malloc(AF_PRODUCT_TABLE_COUNT * AF_PRODUCT_TABLE_SIZE * AF_PRODUCT_TILE_WORDS * sizeof(BITSET_BASE_TYPE));
+	SIZE_TYPE* column_rows = (SIZE_TYPE*) malloc(a->size * sizeof(SIZE_TYPE));
+	BITSET_BASE_TYPE* column_words = (BITSET_BASE_TYPE*) malloc(a->size * sizeof(BITSET_BASE_TYPE));
+	assert(tables != NULL && column_rows != NULL && column_words != NULL);
+
+	for (SIZE_TYPE w = 0; w < base_count; ++w) {
+		SIZE_TYPE count = 0;
+		BITSET_BASE_TYPE used = 0ULL;
+		for (SIZE_TYPE i = 0; i < a->size; ++i) {
+			BITSET_BASE_TYPE aw = AF_ROW(a, i)[w];
+			if (aw == 0ULL)
+				continue;
+			column_rows[count] = i;
+			column_words[count++] = aw;
+			used |= aw;
+		}
+		if (count == 0)
+			continue;
+
+		for (SIZE_TYPE first_word = 0; first_word < base_count; first_word += AF_PRODUCT_TILE_WORDS) {
+			SIZE_TYPE words = base_count - first_word < AF_PRODUCT_TILE_WORDS ? base_count - first_word : AF_PRODUCT_TILE_WORDS;
+			// the tables of the rows 64w, ..., 64w + 63 of b, rows beyond the
+			// last argument are empty
+			for (SIZE_TYPE t = 0; t < AF_PRODUCT_TABLE_COUNT; ++t) {
+				if (((used >> (t * AF_PRODUCT_TABLE_BITS)) & (AF_PRODUCT_TABLE_SIZE - 1)) == 0)
+					continue;
+				BITSET_BASE_TYPE* table = tables + t * AF_PRODUCT_TABLE_SIZE * AF_PRODUCT_TILE_WORDS;
+				SIZE_TYPE first_row = w * BITSET_BASE_SIZE + t * AF_PRODUCT_TABLE_BITS;
+				memset(table, 0, AF_PRODUCT_TILE_WORDS * sizeof(BITSET_BASE_TYPE));
+				for (SIZE_TYPE m = 1; m < AF_PRODUCT_TABLE_SIZE; ++m) {
+					BITSET_BASE_TYPE* entry = table + m * AF_PRODUCT_TILE_WORDS;
+					const BITSET_BASE_TYPE* smaller = table + (m & (m - 1)) * AF_PRODUCT_TILE_WORDS;
+					SIZE_TYPE row = first_row + __builtin_ctz(m);
+					if (row >= b->size) {
+						memcpy(entry, smaller, words * sizeof(BITSET_BASE_TYPE));
+						continue;
+					}
+					const BITSET_BASE_TYPE* b_row = AF_ROW(b, row) + first_word;
+					for (SIZE_TYPE l = 0; l < words; ++l)
+						entry[l] = smaller[l] | b_row[l];
+				}
+			}
+
+			for (SIZE_TYPE c = 0; c < count; ++c) {
+				BITSET_BASE_TYPE aw = column_words[c];
+				BITSET_BASE_TYPE rw[AF_PRODUCT_TILE_WORDS];
+				BITSET_BASE_TYPE* r_row = AF_ROW(r, column_rows[c]) + first_word;
+				for (SIZE_TYPE l = 0; l < words; ++l)
+					rw[l] = r_row[l];
+				for (SIZE_TYPE t = 0; t < AF_PRODUCT_TABLE_COUNT; ++t, aw >>= AF_PRODUCT_TABLE_BITS) {
+					SIZE_TYPE m = aw & (AF_PRODUCT_TABLE_SIZE - 1);
+					if (m == 0)
+						continue;
+					const BITSET_BASE_TYPE* entry = tables + (t * AF_PRODUCT_TABLE_SIZE + m) * AF_PRODUCT_TILE_WORDS;
+					for (SIZE_TYPE l = 0; l < words; ++l)
+						rw[l] |= entry[l];
+				}
+				for (SIZE_TYPE l = 0; l < words; ++l)
+					r_row[l] = rw[l];
+			}
+		}
+	}
+	free(tables);
+	free(column_rows);
+	free(column_words);
+}
+
+AF* product_argumentation_framework(AF* a, AF* b) {
+	AF* p_af = create_argumentation_framework(a->size);
+	boolean_product(a, b, p_af);
+	return(p_af);
+}
+
+AF* two_step_attack_framework(AF* af) {
+	return(product_argumentation_framework(af, af));
+}
+
+AF* defense_framework(AF* af) {
+	// i defends an attacked argument j only if it attacks an attacker of j,
+	// so the candidates come from the two step attacks. The complement of the
+	// defense relation is the product of the complement of af with af, but
+	// that product is dense, checking the few candidates is cheaper. If the
+	// number of paths of length two shows that most pairs are candidates,
+	// the product is skipped and all pairs are checked.
+	AF* attacked_by = get_transpose_framework(af);
+	double paths = 0;
+	for (SIZE_TYPE k = 0; k < af->size; ++k)
+		paths += (double) count_bits(af->graph[k]) * count_bits(attacked_by->graph[k]);
+	bool candidates = paths < (double) af->size * af->size / 4;
+	AF* d_af = candidates ? two_step_attack_framework(af) : create_argumentation_framework(af->size);
+	BitSet* unattacked = create_bitset(af->size);
+	for (SIZE_TYPE j = 0; j < af->size; ++j)
+		if (bitset_is_emptyset(attacked_by->graph[j]))
+			SET_BIT(unattacked, j);
+
+	for (SIZE_TYPE i = 0; i < af->size; ++i) {
+		SIZE_TYPE j;
+		if (candidates) {
+			FOR_EACH_SET_BIT(d_af->graph[i], j)
+				if (!bitset_is_subset(attacked_by->graph[j], af->graph[i]))
+					RESET_BIT(d_af->graph[i], j);
+		} else {
+			for (j = 0; j < af->size; ++j)
+				if (bitset_is_subset(attacked_by->graph[j], af->graph[i]))
+					SET_BIT(d_af->graph[i], j);
+		}
+		bitset_union(d_af->graph[i], unattacked, d_af->graph[i]);
+	}
+	free_bitset(unattacked);
+	release_derived_framework(attacked_by);
+	return(d_af);
+}
+
+// Worklist on the adjacency lists: an argument is accepted when its last
+// attacker is defeated, and the victims of an accepted argument are defeated.
+static void grounded_extension_by_lists(AF* af, BitSet* grounded, BitSet* defeated) {
+	// number of attackers that are not defeated yet
+	SIZE_TYPE* attackers = (SIZE_TYPE*) malloc((af->size > 0 ? af->size : 1) * sizeof(SIZE_TYPE));
+	SIZE_TYPE* worklist = (SIZE_TYPE*) malloc((af->size > 0 ? af->size : 1) * sizeof(SIZE_TYPE));
+	assert(attackers != NULL && worklist != NULL);
+	SIZE_TYPE i, j, k, first = 0, last = 0;
+
+	for (i = 0; i < af->size; ++i) {
+		attackers[i] = AF_ATTACKER_COUNT(af, i);
+		if (attackers[i] == 0)
+			worklist[last++] = i;
+	}
+
+	// every argument enters the worklist at most once, its attackers are
+	// all defeated then and it cannot be defeated later
+	while (first < last) {
+		i = worklist[first++];
+		SET_BIT(grounded, i);
+		FOR_EACH_VICTIM(af, i, j) {
+			if (TEST_BIT(defeated, j))
+				continue;
+			SET_BIT(defeated, j);
+			FOR_EACH_VICTIM(af, j, k)
+				if (--attackers[k] == 0 && !TEST_BIT(defeated, k))
+					worklist[last++] = k;
+		}
+	}
+
+	free(attackers);
+	free(worklist);
+}
+
+// Iteration of the characteristic function on the rows: in each round the
+// undecided arguments whose attackers (a row of the transpose) are all
+// defeated are accepted and their rows are added to the defeated ones, a
+// word at a time. Stops after a round that accepts nothing.
+static void grounded_extension_by_rows(AF* af, BitSet* grounded, BitSet* defeated) {
+	AF* attacked_by = get_transpose_framework(af);
+	BitSet* undecided = create_bitset(af->size);
+	set_bitset(undecided);
+	bool accepted = true;
+	while (accepted) {
+		accepted = false;
+		SIZE_TYPE i;
+		FOR_EACH_SET_BIT(undecided, i) {
+			if (bitset_is_subset(attacked_by->graph[i], defeated)) {
+				SET_BIT(grounded, i);
+				RESET_BIT(undecided, i);
+				bitset_union(defeated, af->graph[i], defeated);
+				accepted = true;
+			}
+		}
+		bitset_set_minus(undecided, defeated, undecided);
+	}
+	free_bitset(undecided);
+	release_derived_framework(attacked_by);
+}
+
+void grounded_extension(AF* af, BitSet* grounded, BitSet* defeated) {
+	reset_bitset(grounded);
+	reset_bitset(defeated);
+	if (HAS_ADJACENCY_LISTS(af))
+		grounded_extension_by_lists(af, grounded, defeated);
+	else
+		grounded_extension_by_rows(af, grounded, defeated);
+}
+
+ClosureBatch* create_closure_batch(SIZE_TYPE size) {
+	ClosureBatch* batch = (ClosureBatch*) malloc(sizeof(ClosureBatch));
+	assert(batch != NULL);
+	batch->size = size;
+	batch->count = 0;
+	batch->down = create_bitset(size);
+	batch->attacked_candidates = (BITSET_BASE_TYPE*) malloc((size > 0 ? size : 1) * sizeof(BITSET_BASE_TYPE));
+	batch->closures = (BITSET_BASE_TYPE*) malloc((size > 0 ? size : 1) * sizeof(BITSET_BASE_TYPE));
+	assert(batch->attacked_candidates != NULL && batch->closures != NULL);
+	return(batch);
+}
+
+void free_closure_batch(ClosureBatch* batch) {
+	free_bitset(batch->down);
+	free(batch->attacked_candidates);
+	free(batch->closures);
+	free(batch);
+}
+
+// The down arrow of s ∪ {c} is down without the attackers of c. An argument x
+// of down removes its victims from the closures of the candidates it does not
+// attack, so the victims of x are collected once for all of them in the
+// words of the victims. The complement is taken at the end.
+void complement_down_up_arrow_batch(AF* af, AF* attacked_by, BitSet* s, ClosureBatch* batch) {
+	BITSET_BASE_TYPE all = batch->count == BITSET_BASE_SIZE ? ~(BITSET_BASE_TYPE) 0 : ((BITSET_BASE_TYPE) 1 << batch->count) - 1;
+	BITSET_BASE_TYPE* attacked_candidates = batch->attacked_candidates;
+	BITSET_BASE_TYPE* closures = batch->closures;
+	SIZE_TYPE b, x, j;
+
+	complement_down_arrow_by_columns(attacked_by, s, batch->down);
+	FOR_EACH_SET_BIT(batch->down, x)
+		attacked_candidates[x] = 0;
+	for (b = 0; b < batch->count; ++b) {
+		if (HAS_ADJACENCY_LISTS(af)) {
+			FOR_EACH_ATTACKER(af, batch->candidates[b], x)
+				if (TEST_BIT(batch->down, x))
+					attacked_candidates[x] |= (BITSET_BASE_TYPE) 1 << b;
+		} else {
+			FOR_EACH_SET_BIT(attacked_by->graph[batch->candidates[b]], x)
+				if (TEST_BIT(batch->down, x))
+					attacked_candidates[x] |= (BITSET_BASE_TYPE) 1 << b;
+		}
+	}
+
+	memset(closures, 0, af->size * sizeof(BITSET_BASE_TYPE));
+	FOR_EACH_SET_BIT(batch->down, x) {
+		BITSET_BASE_TYPE kept = all & ~attacked_candidates[x];
+		if (kept == 0)
+			continue;
+		if (HAS_ADJACENCY_LISTS(af)) {
+			FOR_EACH_VICTIM(af, x, j)
+				closures[j] |= kept;
+		} else {
+			FOR_EACH_SET_BIT(af->graph[x], j)
+				closures[j] |= kept;
+		}
+	}
+	for (j = 0; j < af->size; ++j)
+		closures[j] = all & ~closures[j];
+}
+
+// Every closure contains its candidate, which is not in s. A closure is
+// canonical if its smallest argument outside s is the candidate itself, the
+// words are scanned until the smallest argument of every closure is found.
+BITSET_BASE_TYPE canonical_batch_closures(ClosureBatch* batch, BitSet* s) {
+	BITSET_BASE_TYPE all = batch->count == BITSET_BASE_SIZE ? ~(BITSET_BASE_TYPE) 0 : ((BITSET_BASE_TYPE) 1 << batch->count) - 1;
+	BITSET_BASE_TYPE seen = 0, canonical = 0;
+	for (SIZE_TYPE j = 0; seen != all; ++j) {
+		if (TEST_BIT(s, j))
+			continue;
+		BITSET_BASE_TYPE first = batch->closures[j] & ~seen;
+		seen |= first;
+		for (; first; first &= first - 1) {
+			SIZE_TYPE b = __builtin_ctzll(first);
+			if (batch->candidates[b] == j)
+				canonical |= (BITSET_BASE_TYPE) 1 << b;
+		}
+	}
+	return(canonical);
+}
+
+void get_batch_closure(ClosureBatch* batch, SIZE_TYPE b, BitSet* r) {
+	for (SIZE_TYPE k = 0; k < r->base_count; ++k) {
+		BITSET_BASE_TYPE w = 0;
+		SIZE_TYPE end = (k + 1) * BITSET_BASE_SIZE < batch->size ? (k + 1) * BITSET_BASE_SIZE : batch->size;
+		for (SIZE_TYPE j = k * BITSET_BASE_SIZE; j < end; ++j)
+			w |= ((batch->closures[j] >> b) & 1) << (j - k * BITSET_BASE_SIZE);
+		r->elements[k] = w;
+	}
+}
+
+// Fill the rows of paf->af from the sparse framework af. The arguments of
+// the projection are found by binary search in the sorted parent_mapping,
+// so the work is proportional to the attacks of the projected arguments.
+static void project_sparse_rows(AF* af, BitSet* mask, BitSet* loop_mask, PAF* paf) {
+	SIZE_TYPE size = paf->af->size;
+	for (SIZE_TYPE i = 0; i < size; ++i) {
+		SIZE_TYPE parent = paf->parent_mapping[i];
+		if (loop_mask && TEST_BIT(loop_mask, parent)) {
+			SET_BIT(paf->af->graph[i], i);
+		}
+		SIZE_TYPE j;
+		FOR_EACH_HYBRID_SET_ELEMENT(af->sparse_graph[parent], j) {
+			if (!TEST_BIT(mask, j))
+				continue;
+			SIZE_TYPE low = 0, high = size;
+			while (low < high) {
+				SIZE_TYPE mid = low + (high - low) / 2;
+				if (paf->parent_mapping[mid] < j)
+					low = mid + 1;
+				else
+					high = mid;
+			}
+			SET_BIT(paf->af->graph[i], low);
+		}
+	}
+}
+
+// Fill the rows and the adjacency lists of proj from the adjacency lists of
+// af, proj->parent_mapping lists the arguments of af in mask. The work is
+// proportional to the attacks of the projected arguments. Returns the number
+// of loops added for arguments in loop_mask.
+static SIZE_TYPE project_adjacency_lists(AF* af, BitSet* mask, BitSet* loop_mask, PAF* proj) {
+	SIZE_TYPE size = proj->af->size;
+	SIZE_TYPE* child = (SIZE_TYPE*) malloc((af->size > 0 ? af->size : 1) * sizeof(SIZE_TYPE));
+	assert(child != NULL);
+	size_t att_count = size;
+	for (SIZE_TYPE i = 0; i < size; ++i) {
+		child[proj->parent_mapping[i]] = i;
+		att_count += AF_VICTIM_COUNT(af, proj->parent_mapping[i]);
+	}
+
+	SIZE_TYPE* attacks = (SIZE_TYPE*) malloc(2 * att_count * sizeof(SIZE_TYPE));
+	assert(attacks != NULL);
+	size_t k = 0;
+	SIZE_TYPE loops = 0;
+	for (SIZE_TYPE i = 0; i < size; ++i) {
+		if (loop_mask && TEST_BIT(loop_mask, proj->parent_mapping[i])) {
+			SET_BIT(proj->af->graph[i], i);
+			attacks[2 * k] = attacks[2 * k + 1] = i;
+			++k;
+			++loops;
+		}
+		SIZE_TYPE j;
+		FOR_EACH_VICTIM(af, proj->parent_mapping[i], j) {
+			if (TEST_BIT(mask, j)) {
+				SET_BIT(proj->af->graph[i], child[j]);
+				attacks[2 * k] = i;
+				attacks[2 * k + 1] = child[j];
+				++k;
+			}
+		}
+	}
+	set_adjacency_lists(proj->af, attacks, k);
+
+	free(attacks);
+	free(child);
+	return(loops);
+}
+
+// Fill the rows of proj->af from the dense rows of af, proj->parent_mapping
+// lists the arguments of af in mask. Only the attacks of the projected
+// arguments are visited. Returns the number of loops added for arguments in
+// loop_mask.
+static SIZE_TYPE project_dense_rows(AF* af, BitSet* mask, BitSet* loop_mask, PAF* proj) {
+	SIZE_TYPE size = proj->af->size;
+	SIZE_TYPE* child = (SIZE_TYPE*) malloc((af->size > 0 ? af->size : 1) * sizeof(SIZE_TYPE));
+	assert(child != NULL);
+	for (SIZE_TYPE i = 0; i < size; ++i)
+		child[proj->parent_mapping[i]] = i;
+
+	SIZE_TYPE loops = 0;
+	for (SIZE_TYPE i = 0; i < size; ++i) {
+		if (loop_mask && TEST_BIT(loop_mask, proj->parent_mapping[i])) {
+			SET_BIT(proj->af->graph[i], i);
+			++loops;
+		}
+		SIZE_TYPE j;
+		FOR_EACH_SET_BIT(af->graph[proj->parent_mapping[i]], j)
+			if (TEST_BIT(mask, j))
+				SET_BIT(proj->af->graph[i], child[j]);
+	}
+
+	free(child);
+	return(loops);
+}
+
 PAF* project_argumentation_framework_with_loops(AF* af, BitSet* mask, BitSet* loop_mask) {
 	PAF* paf = calloc(1, sizeof(PAF));
 	assert(paf != NULL);
@@ -133,25 +909,24 @@ PAF* project_argumentation_framework_with_loops(AF* af, BitSet* mask, BitSet* lo
 
     paf->base_mapping = calloc(size, sizeof(SIZE_TYPE));
     paf->parent_mapping = calloc(size, sizeof(SIZE_TYPE));
-    SIZE_TYPE j = 0;
-    for (SIZE_TYPE i = 0; i < af->size; ++i) {
-        if (TEST_BIT(mask, i)) {
-			paf->parent_mapping[j] = i;
-            paf->base_mapping[j++] = i;
-        }
+    SIZE_TYPE i, j = 0;
+    FOR_EACH_SET_BIT(mask, i) {
+		paf->parent_mapping[j] = i;
+        paf->base_mapping[j++] = i;
     }
 
     paf->af = create_argumentation_framework(size);
-    for (SIZE_TYPE i = 0; i < size; ++i) {
-		if (loop_mask && TEST_BIT(loop_mask, paf->parent_mapping[i])) {
-			SET_BIT(paf->af->graph[i], i);
-		}
-        for (SIZE_TYPE j = 0; j < size; ++j) {
-            if (CHECK_ARG_ATTACKS_ARG(af, paf->parent_mapping[i], paf->parent_mapping[j])) {
-				SET_BIT(paf->af->graph[i], j);
-            }
-        }
-    }
+	if (HAS_ADJACENCY_LISTS(af)) {
+		project_adjacency_lists(af, mask, loop_mask, paf);
+		paf->base_size = af->size;
+		return paf;
+	}
+	if (IS_SPARSE_AF(af)) {
+		project_sparse_rows(af, mask, loop_mask, paf);
+		paf->base_size = af->size;
+		return paf;
+	}
+	project_dense_rows(af, mask, loop_mask, paf);
 
 	paf->base_size = af->size;
 
@@ -173,27 +948,19 @@ PAF* project_paf_with_loops(PAF* paf, BitSet* mask, BitSet* loop_mask) {
 
     proj->base_mapping = calloc(size, sizeof(SIZE_TYPE));
     proj->parent_mapping = calloc(size, sizeof(SIZE_TYPE));
-    SIZE_TYPE j = 0;
-    for (SIZE_TYPE i = 0; i < paf->af->size; ++i) {
-        if (TEST_BIT(mask, i)) {
-			proj->parent_mapping[j] = i;
-            proj->base_mapping[j++] = paf->base_mapping[i];
-        }
+    SIZE_TYPE i, j = 0;
+    FOR_EACH_SET_BIT(mask, i) {
+		proj->parent_mapping[j] = i;
+        proj->base_mapping[j++] = paf->base_mapping[i];
     }
 
     proj->af = create_argumentation_framework(size);
-	bool loops = 0;
-    for (SIZE_TYPE i = 0; i < size && loops < size; ++i) {
-		if (loop_mask && TEST_BIT(loop_mask, proj->parent_mapping[i])) {
-			SET_BIT(proj->af->graph[i], i);
-			++loops;
-		}
-        for (SIZE_TYPE j = 0; j < size; ++j) {
-            if (CHECK_ARG_ATTACKS_ARG(paf->af, proj->parent_mapping[i], proj->parent_mapping[j])) {
-				SET_BIT(proj->af->graph[i], j);
-            }
-        }
-    }
+	SIZE_TYPE loops = 0;
+	if (HAS_ADJACENCY_LISTS(paf->af)) {
+		loops = project_adjacency_lists(paf->af, mask, loop_mask, proj);
+	} else {
+		loops = project_dense_rows(paf->af, mask, loop_mask, proj);
+	}
 
 	if (loops == size) {
 		free_projected_argumentation_framework(proj);
@@ -221,19 +988,79 @@ PAF* af2paf(AF* af)
 
 BitSet* project_back(BitSet* bs, PAF* paf) {
 	BitSet* res = create_bitset(paf->base_size);
-	for (SIZE_TYPE i = 0; i < paf->af->size; ++i) {
-		if (TEST_BIT(bs, i)) {
-			SET_BIT(res, paf->base_mapping[i]);
-		}
+	SIZE_TYPE i;
+	FOR_EACH_SET_BIT(bs, i) {
+		SET_BIT(res, paf->base_mapping[i]);
 	}
 	return res;
 }
 
 
+PAFView* create_paf_view(AF* af) {
+	PAFView* view = calloc(1, sizeof(PAFView));
+	assert(view != NULL);
+	view->af = af;
+	view->arguments = create_bitset(af->size);
+	set_bitset(view->arguments);
+	view->size = af->size;
+	return(view);
+}
+
+PAFView* restrict_paf_view(PAFView* view, BitSet* mask, BitSet* loop_mask) {
+	BitSet* arguments = create_bitset(view->af->size);
+	bitset_intersection(view->arguments, mask, arguments);
+	BitSet* loops = NULL;
+	if (view->loops || loop_mask) {
+		loops = create_bitset(view->af->size);
+		if (view->loops)
+			bitset_union(loops, view->loops, loops);
+		if (loop_mask)
+			bitset_union(loops, loop_mask, loops);
+		bitset_intersection(loops, arguments, loops);
+		// every argument attacks itself, the only extension is the empty one
+		if (bitset_is_subset(arguments, loops)) {
+			free_bitset(arguments);
+			free_bitset(loops);
+			return(NULL);
+		}
+	}
+
+	PAFView* r = calloc(1, sizeof(PAFView));
+	assert(r != NULL);
+	r->af = view->af;
+	r->arguments = arguments;
+	r->loops = loops;
+	r->size = count_bits(arguments);
+	return(r);
+}
+
+PAF* project_paf_view(PAFView* view, BitSet* mask) {
+	BitSet* arguments = create_bitset(view->af->size);
+	bitset_intersection(view->arguments, mask, arguments);
+	PAF* paf = project_argumentation_framework_with_loops(view->af, arguments, view->loops);
+	free_bitset(arguments);
+	return(paf);
+}
+
+void free_paf_view(PAFView* view) {
+	free_bitset(view->arguments);
+	if (view->loops)
+		free_bitset(view->loops);
+	free(view);
+}
+
+
 void swap_arguments(AF* af, SIZE_TYPE i, SIZE_TYPE j) {
-	BitSet* iset = af->graph[i];
-	af->graph[i] = af->graph[j];
-	af->graph[j] = iset;
+	drop_derived_data(af);
+
+	// swap the row contents, graph[i] stays the view on row i of the matrix
+	BITSET_BASE_TYPE* irow = AF_ROW(af, i);
+	BITSET_BASE_TYPE* jrow = AF_ROW(af, j);
+	for (SIZE_TYPE k = 0; k < af->row_stride; ++k) {
+		BITSET_BASE_TYPE w = irow[k];
+		irow[k] = jrow[k];
+		jrow[k] = w;
+	}
 
 	for (SIZE_TYPE k = 0; k < af->size; ++k) {
 		bool ibit = TEST_BIT(af->graph[k], i);
@@ -253,12 +1080,11 @@ void swap_arguments(AF* af, SIZE_TYPE i, SIZE_TYPE j) {
 // Map indices of bitset s according to the mapping.
 // Return the new bitset
 BitSet *map_indices(BitSet *s, int *mapping) {
-  int i;
+  SIZE_TYPE i;
   BitSet* c = create_bitset(s->size);
 
-  for (i = 0; i < s->size; ++i)
-    if (TEST_BIT(s, i))
-      SET_BIT(c, mapping[i]);
+  FOR_EACH_SET_BIT(s, i)
+    SET_BIT(c, mapping[i]);
 
   return(c);
 }
\ No newline at end of file
@@ -20,17 +20,54 @@
 #include <stdbool.h>
 
 #include "../bitset/bitset.h"
+#include "../bitset/bitset_fixed_width.h"
+#include "../bitset/hybrid_set.h"
 
 
+typedef struct argumentation_framework AF;
+
 struct argumentation_framework {
 	// Number of arguments
 	SIZE_TYPE size;
 	// The adjacency matrix: array of bitsets
 	BitSet **graph;
+	// The words of all rows in one cache line aligned block.
+	// graph[i] is a view on row i, which starts at matrix + i * row_stride.
+	BITSET_BASE_TYPE* matrix;
+	SIZE_TYPE row_stride;
+	// headers of the row views
+	BitSet* rows;
+	// Sparse storage: sparse_graph[i] contains the victims of argument i.
+	// NULL for dense frameworks. In a sparse framework graph, matrix and
+	// rows are NULL. Only the weak component splitting, the projections and
+	// the grounded extension work on sparse frameworks, the closure
+	// operators and the solvers need the dense rows.
+	HybridSet** sparse_graph;
+	// The attacks as compressed sparse rows: the victims of argument i are
+	// victims[victim_offsets[i]] ... victims[victim_offsets[i + 1] - 1] in
+	// increasing order, the attackers are stored the same way. NULL if the
+	// lists have not been built. Functions that change the attacks of a
+	// framework drop its lists.
+	size_t* victim_offsets;
+	SIZE_TYPE* victims;
+	size_t* attacker_offsets;
+	SIZE_TYPE* attackers;
+	// The weakly connected components: component_of[i] is the smallest
+	// argument connected to i by attacks in either direction. NULL if they
+	// have not been found, dropped with the derived data.
+	SIZE_TYPE* component_of;
+	SIZE_TYPE component_count;
+	// Derived frameworks, built on first use and kept until af is freed or
+	// changed (see get_complement_framework). NULL if not built.
+	AF* complement;
+	AF* transpose;
+	AF* conflicts;
+	// For a derived framework: the framework it belongs to and the number
+	// of users currently holding it.
+	AF* derived_from;
+	SIZE_TYPE ref_count;
 };
 
-typedef struct argumentation_framework AF;
-
 
 struct projected_argumentation_framework {
 	AF* af;
@@ -43,19 +80,143 @@ struct projected_argumentation_framework {
 
 typedef struct projected_argumentation_framework PAF;
 
+// A subframework of af read in place: the arguments in arguments, with the
+// attacks of af among them and a self-attack added for each argument in
+// loops. Arguments keep their indices in af, so views of views restrict the
+// masks and their extensions need no mapping back. Only the parts handed to
+// a solver are copied, with project_paf_view.
+struct projected_argumentation_framework_view {
+	AF* af;
+	BitSet* arguments;
+	// NULL if no loops are added
+	BitSet* loops;
+	SIZE_TYPE size;
+};
+
+typedef struct projected_argumentation_framework_view PAFView;
+
 
 // Create argumentation framework with the given number of arguments
 AF* create_argumentation_framework(SIZE_TYPE size);
 
+// Create a sparse argumentation framework with the given number of arguments.
+// victim_counts[i] is the expected number of victims of argument i.
+AF* create_sparse_argumentation_framework(SIZE_TYPE size, SIZE_TYPE* victim_counts);
+
 // Free the space allocated for af
 // Return the number of bytes freed
-int free_argumentation_framework(AF *af);
+size_t free_argumentation_framework(AF *af);
+
+// Return a dense copy of the sparse framework af
+AF* dense_argumentation_framework(AF* af);
+
+#define IS_SPARSE_AF(af)	((af)->sparse_graph != NULL)
+
+// Memory planning: the solvers typically keep the framework, its complement
+// and its transpose as dense matrices.
+#define AF_DENSE_MATRIX_COPIES	3
+
+enum af_storage {AF_STORAGE_DENSE, AF_STORAGE_SPARSE};
+
+// Estimated bytes needed by the solver for a dense framework with the given
+// numbers of arguments and attacks, with its adjacency lists
+size_t dense_af_bytes(SIZE_TYPE size, size_t att_count);
+
+// Bytes of a sparse framework with the given numbers of arguments and
+// attacks, with its adjacency lists
+size_t sparse_af_bytes(SIZE_TYPE size, size_t att_count);
+
+// Dense storage if it fits in memory_budget bytes (0: no limit) or the sparse
+// rows would not be smaller, otherwise sparse
+enum af_storage plan_af_storage(SIZE_TYPE size, size_t att_count, size_t memory_budget);
+
+// Half of the physical memory, 0 if it cannot be determined
+size_t default_memory_budget();
+
+#define HAS_ADJACENCY_LISTS(af)		((af)->victim_offsets != NULL)
+
+// Number of victims / attackers of argument i, the lists must exist
+#define AF_VICTIM_COUNT(af,i)		((af)->victim_offsets[(i) + 1] - (af)->victim_offsets[i])
+#define AF_ATTACKER_COUNT(af,i)		((af)->attacker_offsets[(i) + 1] - (af)->attacker_offsets[i])
+
+// Loop j over the victims / attackers of argument i in increasing order
+#define FOR_EACH_VICTIM(af,i,j)		for (size_t j##_pos = (af)->victim_offsets[i]; j##_pos < (af)->victim_offsets[(i) + 1] && ((j) = (af)->victims[j##_pos], 1); ++j##_pos)
+#define FOR_EACH_ATTACKER(af,i,j)	for (size_t j##_pos = (af)->attacker_offsets[i]; j##_pos < (af)->attacker_offsets[(i) + 1] && ((j) = (af)->attackers[j##_pos], 1); ++j##_pos)
+
+// Set the adjacency lists of af from att_count attacks given as pairs of
+// indices starting from 0: attacks[2k] attacks attacks[2k + 1]. Duplicate
+// attacks are stored once. Takes O(size + att_count) time.
+void set_adjacency_lists(AF* af, SIZE_TYPE* attacks, size_t att_count);
+
+// Build the adjacency lists of af from its rows, if it does not have them
+void build_adjacency_lists(AF* af);
+
+void free_adjacency_lists(AF* af);
+
+// Union-find over the arguments, parent[i] == i for the roots. The root of a
+// set is its smallest argument, so parent[i] <= i.
+inline SIZE_TYPE find_argument_root(SIZE_TYPE* parent, SIZE_TYPE i) {
+	while (parent[i] != i) {
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return(i);
+}
+
+inline void union_arguments(SIZE_TYPE* parent, SIZE_TYPE i, SIZE_TYPE j) {
+	i = find_argument_root(parent, i);
+	j = find_argument_root(parent, j);
+	if (i < j)
+		parent[j] = i;
+	else
+		parent[i] = j;
+}
+
+// Set the weakly connected components of af from parent, a union-find in
+// which the arguments of every attack are joined. af takes parent over.
+void set_weak_components(AF* af, SIZE_TYPE* parent);
+
+// Find the weakly connected components of af from its attacks, if it does
+// not have them
+void build_weak_components(AF* af);
+
+// The complement, the transpose and the conflict framework (undirected,
+// loops spread to all neighbours, see create_conflict_framework) of af.
+// Each is built once on first use and shared by all later callers. The
+// result must not be changed, hand it back with release_derived_framework.
+AF* get_complement_framework(AF* af);
+AF* get_transpose_framework(AF* af);
+AF* get_conflict_framework(AF* af);
+void release_derived_framework(AF* derived);
+
+// Drop the adjacency lists and the derived frameworks of af.
+// Call it after changing the attacks of af.
+void drop_derived_data(AF* af);
+
+// Memory accounting of the derived frameworks
+struct af_cache_stats {
+	size_t built;
+	size_t reused;
+	size_t evicted;
+	// bytes of the derived frameworks currently kept, and the maximum
+	size_t bytes;
+	size_t peak_bytes;
+};
+
+extern struct af_cache_stats af_cache_stats;
+
+// Derived frameworks nobody holds are freed on release while the kept ones
+// take more than limit bytes (0: no limit, keep them until af is freed)
+void set_af_cache_limit(size_t limit);
 
 void free_paf(PAF* paf, bool free_af);
 void free_projected_argumentation_framework(PAF *af);
 
 void print_argumentation_framework(AF *af);
 
+// Words of row i of the adjacency matrix
+#define AF_ROW(af,i)		((af)->matrix + (size_t) (i) * (af)->row_stride)
+
 // Add an attack from argument at index i to argument at index j
 // "i-1" and "j-1" since the arguments in the input file start with "1"
 #define ADD_ATTACK(af,i,j)		SET_BIT(af->graph[i-1],j-1)
@@ -71,8 +232,17 @@ void print_argumentation_framework(AF *af);
 // Check if set s attacks argument arg
 // Return 1 if yes, 0 otherwise
 inline char check_set_attacks_arg(AF* af, BitSet* s, int arg) {
-	for (SIZE_TYPE i = 0; i < af->size; ++i)
-		if (TEST_BIT(s,i) && CHECK_ARG_ATTACKS_ARG(af, i, arg))
+	SIZE_TYPE i;
+	// look up the attackers of arg in s if there are fewer of them than
+	// words in s
+	if (HAS_ADJACENCY_LISTS(af) && AF_ATTACKER_COUNT(af, arg) <= s->base_count) {
+		FOR_EACH_ATTACKER(af, arg, i)
+			if (TEST_BIT(s, i))
+				return(1);
+		return(0);
+	}
+	FOR_EACH_SET_BIT(s, i)
+		if (CHECK_ARG_ATTACKS_ARG(af, i, arg))
 			return(1);
 	return(0);
 }
@@ -81,6 +251,13 @@ inline char check_set_attacks_arg(AF* af, BitSet* s, int arg) {
 // Return 1 if yes, 0 otherwise
 inline char check_set_defends_arg(AF* af, BitSet* s, int arg) {
 	// Check if s attacks all attackers of arg
+	if (HAS_ADJACENCY_LISTS(af)) {
+		SIZE_TYPE i;
+		FOR_EACH_ATTACKER(af, arg, i)
+			if (!check_set_attacks_arg(af, s, i))
+				return(0);
+		return(1);
+	}
 	for (SIZE_TYPE i = 0; i < af->size; ++i)
 		if (CHECK_ARG_ATTACKS_ARG(af, i, arg) && !check_set_attacks_arg(af, s, i))
 			return(0);
@@ -116,8 +293,9 @@ inline char is_set_conflict_free(AF* af, BitSet* s) {
 */
 // TODO: Compare to above
 inline char is_set_conflict_free(AF* af, BitSet* s) {
-	for (SIZE_TYPE i = 0; i < af->size; ++i)
-		if (TEST_BIT(s, i) && CHECK_ARG_ATTACKS_SET(af, i, s))
+	SIZE_TYPE i;
+	FOR_EACH_SET_BIT(s, i)
+		if (CHECK_ARG_ATTACKS_SET(af, i, s))
 			return(0);
 	return(1);
 }
@@ -127,11 +305,10 @@ inline char is_set_conflict_free(AF* af, BitSet* s) {
 // s: the given bitset
 // r: result bitset containing attackers of s
 static inline void get_attackers(AF* attacked_by, BitSet* s, BitSet* r) {
+	SIZE_TYPE i;
 	reset_bitset(r);
-	for (SIZE_TYPE i = 0; i < attacked_by->size; ++i) {
-		if (TEST_BIT(s, i))
-			bitset_union(r, attacked_by->graph[i], r);
-	}
+	FOR_EACH_SET_BIT(s, i)
+		bitset_union(r, attacked_by->graph[i], r);
 }
 
 
@@ -149,31 +326,61 @@ static inline void get_true_attackers(AF* af, BitSet* s, BitSet* r) {
 // s: the given bitset
 // r: result bitset containing arguments attacked by s
 static inline void get_victims(AF* attacks, BitSet* s, BitSet* r) {
+	SIZE_TYPE i;
 	reset_bitset(r);
-	for (SIZE_TYPE i = 0; i < attacks->size; ++i) {
-		if (TEST_BIT(s, i))
-			bitset_union(r, attacks->graph[i], r);
-	}
+	FOR_EACH_SET_BIT(s, i)
+		bitset_union(r, attacks->graph[i], r);
 }
 
+// The closure operators below built for the frameworks whose rows take 1, 2,
+// 4 or 8 words, at most 512 arguments, on BitSet##W values (see
+// af_fixed_width.c). The rows of a dense framework are row_stride words
+// apart, a power of two, so row_stride selects the width. The other
+// frameworks use the generic loops.
+#define DECLARE_FIXED_WIDTH_OPERATORS(W)									\
+	void up_arrow_##W(AF* af, BitSet* s, BitSet* r);						\
+	void down_arrow_##W(AF* af, BitSet* s, BitSet* r);						\
+	void down_up_arrow_##W(AF* af, BitSet* s, BitSet* r);					\
+	void complement_up_arrow_##W(AF* af, BitSet* s, BitSet* r);				\
+	void complement_down_arrow_##W(AF* af, BitSet* s, BitSet* r);			\
+	void complement_down_up_arrow_##W(AF* af, BitSet* s, BitSet* r);
+
+DECLARE_FIXED_WIDTH_OPERATORS(1)
+DECLARE_FIXED_WIDTH_OPERATORS(2)
+DECLARE_FIXED_WIDTH_OPERATORS(4)
+DECLARE_FIXED_WIDTH_OPERATORS(8)
+
+// Run the operator built for the width of af and return, if there is one
+#define RUN_FIXED_WIDTH_OPERATOR(operator, af, s, r)						\
+	if ((af)->matrix) {														\
+		switch ((af)->row_stride) {											\
+			case 1: operator##_1(af, s, r); return;							\
+			case 2: operator##_2(af, s, r); return;							\
+			case 4: operator##_4(af, s, r); return;							\
+			case 8: operator##_8(af, s, r); return;							\
+		}																	\
+	}
+
 // Compute common victims of the arguments in s (arguments attacked by all elements of s)
 // (up-arrow in FCA terms) Put the result in r
 // inline void up_arrow(AF* af, BitSet* s, BitSet* r) {
 static inline void up_arrow(AF* af, BitSet* s, BitSet* r) {
+	RUN_FIXED_WIDTH_OPERATOR(up_arrow, af, s, r);
+
 	// First fill r
-	// TODO: Improve efficiency?
+	SIZE_TYPE i;
 	set_bitset(r);
 
-	for (SIZE_TYPE i = 0; i < af->size; ++i)
-		if (TEST_BIT(s, i))
-			bitset_intersection(r, af->graph[i], r);
+	FOR_EACH_SET_BIT(s, i)
+		bitset_intersection(r, af->graph[i], r);
 }
 
 // Compute total attackers of s (arguments attacking all elements of s)
 // (down-arrow in FCA terms) Put the result in r
 // inline void get_total_attackers(AF* af, BitSet* s, BitSet* r) {
 static inline void down_arrow(AF* af, BitSet* s, BitSet* r) {
-	// TODO: Improve efficiency?
+	RUN_FIXED_WIDTH_OPERATOR(down_arrow, af, s, r);
+
 	reset_bitset(r);
 
 	for (SIZE_TYPE i = 0; i < af->size; ++i)
@@ -186,8 +393,9 @@ static inline void down_arrow(AF* af, BitSet* s, BitSet* r) {
 // In FCA: down-up-arrow closure operator on the formal context)
 // inline void get_common_victims_of_total_attackers(AF* af, BitSet* s, BitSet* r) {
 static inline void down_up_arrow(AF* af, BitSet* s, BitSet* r) {
+	RUN_FIXED_WIDTH_OPERATOR(down_up_arrow, af, s, r);
+
 	// First fill r
-	// TODO: Improve efficiency?
 	set_bitset(r);
 
 	for (SIZE_TYPE i = 0; i < af->size; ++i) {
@@ -197,12 +405,148 @@ static inline void down_up_arrow(AF* af, BitSet* s, BitSet* r) {
 	}
 }
 
+// The closure operators of the complement of af (the not-attacks relation
+// the stable and preferred solvers work on), computed on the rows of af so
+// that the complement does not have to be built. The intersections with a
+// complemented row are set differences, the subset tests are disjointness
+// tests.
+
+// up_arrow on the complement: arguments attacked by no element of s
+static inline void complement_up_arrow(AF* af, BitSet* s, BitSet* r) {
+	RUN_FIXED_WIDTH_OPERATOR(complement_up_arrow, af, s, r);
+
+	SIZE_TYPE i;
+	set_bitset(r);
+
+	FOR_EACH_SET_BIT(s, i)
+		bitset_set_minus(r, af->graph[i], r);
+}
+
+// down_arrow on the complement: arguments attacking no element of s
+static inline void complement_down_arrow(AF* af, BitSet* s, BitSet* r) {
+	RUN_FIXED_WIDTH_OPERATOR(complement_down_arrow, af, s, r);
+
+	reset_bitset(r);
+
+	for (SIZE_TYPE i = 0; i < af->size; ++i)
+		if (is_bitset_intersection_empty(s, af->graph[i]))
+			SET_BIT(r, i);
+}
+
+// down_up_arrow on the complement
+static inline void complement_down_up_arrow(AF* af, BitSet* s, BitSet* r) {
+	RUN_FIXED_WIDTH_OPERATOR(complement_down_up_arrow, af, s, r);
+
+	set_bitset(r);
+
+	for (SIZE_TYPE i = 0; i < af->size; ++i)
+		if (is_bitset_intersection_empty(s, af->graph[i]))
+			bitset_set_minus(r, af->graph[i], r);
+}
+
+// Column-indexed closure operators and attack queries. attacked_by is the
+// transpose of af (see get_transpose_framework), its row j holds the
+// attackers of j. The down arrows are then computed from the rows of the
+// elements of s, |s| * n / 64 word operations instead of a scan over all
+// n rows of af.
+
+// down_arrow(af, s, r): the arguments attacking all elements of s
+static inline void down_arrow_by_columns(AF* attacked_by, BitSet* s, BitSet* r) {
+	up_arrow(attacked_by, s, r);
+}
+
+// down_up_arrow(af, s, r), down receives down_arrow(af, s, down)
+static inline void down_up_arrow_by_columns(AF* af, AF* attacked_by, BitSet* s, BitSet* down, BitSet* r) {
+	up_arrow(attacked_by, s, down);
+	up_arrow(af, down, r);
+}
+
+// complement_down_arrow(af, s, r): the arguments attacking no element of s
+static inline void complement_down_arrow_by_columns(AF* attacked_by, BitSet* s, BitSet* r) {
+	complement_up_arrow(attacked_by, s, r);
+}
+
+// complement_down_up_arrow(af, s, r), down receives complement_down_arrow(af, s, down)
+static inline void complement_down_up_arrow_by_columns(AF* af, AF* attacked_by, BitSet* s, BitSet* down, BitSet* r) {
+	complement_up_arrow(attacked_by, s, down);
+	complement_up_arrow(af, down, r);
+}
+
+// check_set_attacks_arg(af, s, arg) with a single row intersection
+static inline char check_set_attacks_arg_by_columns(AF* attacked_by, BitSet* s, int arg) {
+	return(!is_bitset_intersection_empty(s, attacked_by->graph[arg]));
+}
+
+// check_set_defends_arg(af, s, arg): s attacks every attacker of arg
+static inline char check_set_defends_arg_by_columns(AF* attacked_by, BitSet* s, int arg) {
+	SIZE_TYPE i;
+	FOR_EACH_SET_BIT(attacked_by->graph[arg], i)
+		if (is_bitset_intersection_empty(s, attacked_by->graph[i]))
+			return(0);
+	return(1);
+}
+
+// Batched closures for the successor loops of Close-by-One and Next-Closure:
+// complement_down_up_arrow(af, s ∪ {c}) for up to BITSET_BASE_SIZE
+// candidates c in one pass over the rows of complement_down_arrow(af, s),
+// instead of one pass per candidate. The closures are bit-sliced, bit b of
+// closures[j] is set if j is in the closure of s ∪ {candidates[b]}.
+typedef struct closure_batch ClosureBatch;
+
+struct closure_batch {
+	SIZE_TYPE size;
+	// number of candidates
+	SIZE_TYPE count;
+	SIZE_TYPE candidates[BITSET_BASE_SIZE];
+	// complement_down_arrow(af, s)
+	BitSet* down;
+	// for an argument x in down, the candidates that x attacks
+	BITSET_BASE_TYPE* attacked_candidates;
+	// one word per argument
+	BITSET_BASE_TYPE* closures;
+};
+
+// Create a batch for frameworks of the given size.
+ClosureBatch* create_closure_batch(SIZE_TYPE size);
+
+void free_closure_batch(ClosureBatch* batch);
+
+// Compute the closures of s with each of the candidates of batch. attacked_by
+// is the transpose of af, the candidates must not be in s. Takes
+// O(|s| * n / 64 + n) word operations and one operation per attack of an
+// argument in down on the rows, or on the lists if af has them.
+void complement_down_up_arrow_batch(AF* af, AF* attacked_by, BitSet* s, ClosureBatch* batch);
+
+// The candidates b of batch whose closure passes the canonicity test: no
+// argument of the closure outside s is smaller than candidates[b].
+BITSET_BASE_TYPE canonical_batch_closures(ClosureBatch* batch, BitSet* s);
+
+// Put the closure of candidate b of batch into r
+void get_batch_closure(ClosureBatch* batch, SIZE_TYPE b, BitSet* r);
+
 AF* complement_argumentation_framework(AF *af );
 
 AF* transpose_argumentation_framework(AF *af);
 
 AF* create_conflict_framework(AF* af);	// make it undirected
 
+// Boolean product of the attack matrices: i attacks j in the result if i
+// attacks some k in a that attacks j in b.
+AF* product_argumentation_framework(AF* a, AF* b);
+
+// i attacks j in the result if i attacks an attacker of j.
+AF* two_step_attack_framework(AF* af);
+
+// The defense relation: i attacks j in the result if i defends j, that is,
+// if i attacks every attacker of j.
+AF* defense_framework(AF* af);
+
+// The grounded extension of af in grounded and the arguments it attacks in
+// defeated. It is contained in every complete extension, and the defeated
+// arguments are in none. Takes O(size + attacks) time with adjacency lists,
+// otherwise the characteristic function is iterated on the rows of af.
+void grounded_extension(AF* af, BitSet* grounded, BitSet* defeated);
+
 PAF* project_argumentation_framework(AF *af, BitSet* mask);
 
 // stores af in PAF and sets index_mapping to identity
@@ -217,6 +561,17 @@ PAF* project_paf_with_loops(PAF* paf, BitSet* mask, BitSet* loop_mask);
 // translate bs into the root (not parent!) framework of paf
 BitSet* project_back(BitSet* bs, PAF* paf);
 
+// view of all arguments of af
+PAFView* create_paf_view(AF* af);
+// view of the arguments of view in mask, with loops added for the arguments
+// in loop_mask, NULL if every argument of the result attacks itself through
+// an added loop. Masks are indexed by the arguments of view->af.
+PAFView* restrict_paf_view(PAFView* view, BitSet* mask, BitSet* loop_mask);
+// copy of the arguments of view in mask, the base mapping of the result
+// refers to view->af
+PAF* project_paf_view(PAFView* view, BitSet* mask);
+void free_paf_view(PAFView* view);
+
 // swap the order of arguments i and j
 void swap_arguments(AF* af, SIZE_TYPE i, SIZE_TYPE j); 
 
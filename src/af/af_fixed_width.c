@@ -0,0 +1,81 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "af.h"
+
+// The closure operators of af.h for the frameworks whose rows take W words,
+// on the BitSet##W values of bitset_fixed_width.h. s and r are kept in
+// registers while the rows are scanned, r is written back once at the end.
+// ROW is applied to the words of the rows: the identity gives the operators
+// of af, the negation the ones of its complement (see complement_up_arrow).
+// The rows are read W words at a time, row_stride is W, and only the
+// base_count words of s and r are accessed, the last one masked.
+
+#define ROW_PLAIN(x)		(x)
+#define ROW_COMPLEMENT(x)	(~(x))
+
+#define DEFINE_FIXED_WIDTH_OPERATORS(W, PREFIX, ROW)							\
+																				\
+void PREFIX##up_arrow_##W(AF* af, BitSet* s, BitSet* r) {						\
+	BitSet##W rw = bitset##W##_full();											\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		for (BITSET_BASE_TYPE w = k < s->base_count ? s->elements[k] : 0ULL;	\
+				w; w &= w - 1) {												\
+			const BITSET_BASE_TYPE* row =										\
+				AF_ROW(af, k * BITSET_BASE_SIZE + __builtin_ctzll(w));			\
+			FOR_EACH_FIXED_WIDTH_WORD(W, l)										\
+				rw.words[l] &= ROW(row[l]);										\
+		}																		\
+	bitset##W##_store(rw, r);													\
+	r->elements[r->base_count - 1] &= get_last_full_block(r);					\
+}																				\
+																				\
+void PREFIX##down_arrow_##W(AF* af, BitSet* s, BitSet* r) {						\
+	BitSet##W sw = bitset##W##_load(s), rw = bitset##W##_empty();				\
+	for (SIZE_TYPE i = 0; i < af->size; ++i) {									\
+		const BITSET_BASE_TYPE* row = AF_ROW(af, i);							\
+		BITSET_BASE_TYPE missing = 0ULL;										\
+		FOR_EACH_FIXED_WIDTH_WORD(W, k)											\
+			missing |= sw.words[k] & ~ROW(row[k]);								\
+		if (missing == 0ULL)													\
+			FIXED_WIDTH_SET_BIT(rw, i);											\
+	}																			\
+	bitset##W##_store(rw, r);													\
+}																				\
+																				\
+void PREFIX##down_up_arrow_##W(AF* af, BitSet* s, BitSet* r) {					\
+	BitSet##W sw = bitset##W##_load(s), rw = bitset##W##_full();				\
+	for (SIZE_TYPE i = 0; i < af->size; ++i) {									\
+		const BITSET_BASE_TYPE* row = AF_ROW(af, i);							\
+		BITSET_BASE_TYPE missing = 0ULL;										\
+		FOR_EACH_FIXED_WIDTH_WORD(W, k)											\
+			missing |= sw.words[k] & ~ROW(row[k]);								\
+		if (missing == 0ULL)													\
+			FOR_EACH_FIXED_WIDTH_WORD(W, k)										\
+				rw.words[k] &= ROW(row[k]);										\
+	}																			\
+	bitset##W##_store(rw, r);													\
+	r->elements[r->base_count - 1] &= get_last_full_block(r);					\
+}
+
+#define DEFINE_FIXED_WIDTH_OPERATOR_PAIR(W)										\
+	DEFINE_FIXED_WIDTH_OPERATORS(W, , ROW_PLAIN)								\
+	DEFINE_FIXED_WIDTH_OPERATORS(W, complement_, ROW_COMPLEMENT)
+
+DEFINE_FIXED_WIDTH_OPERATOR_PAIR(1)
+DEFINE_FIXED_WIDTH_OPERATOR_PAIR(2)
+DEFINE_FIXED_WIDTH_OPERATOR_PAIR(4)
+DEFINE_FIXED_WIDTH_OPERATOR_PAIR(8)
@@ -0,0 +1,109 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AF_AF_FIXED_WIDTH_H_
+#define AF_AF_FIXED_WIDTH_H_
+
+#include "af.h"
+#include "../bitset/bitset_fixed_width.h"
+
+// Frameworks of at most FIXED_WIDTH_CAPACITY(W) arguments with their rows as
+// BitSet##W values, for the solvers built once per width. An AF##W is filled
+// from a dense AF in place and owns no memory. It takes
+// 2 * FIXED_WIDTH_CAPACITY(W) * 8 * W bytes, 64 KB for W = 8, so the solvers
+// allocate it once per call instead of keeping it on the stack.
+// attacked_by[j] holds the attackers of j, the closure operators below are
+// the column-indexed complement operators of af.h.
+//
+// Only the Next-Closure EE-ST, SE-ST and EE-PR solvers are built per width
+// (next_closure_fixed_width.c). The other solvers work on BitSet for every
+// size, through the closure operators of af.h, which are built per width on
+// BitSet##W in af_fixed_width.c.
+
+// The largest framework the solvers are built for
+#define AF_FIXED_WIDTH_MAX_SIZE		FIXED_WIDTH_CAPACITY(8)
+
+// The width of the solvers for af, 0 if af is sparse or larger than
+// AF_FIXED_WIDTH_MAX_SIZE
+static inline SIZE_TYPE af_fixed_width(AF* af) {
+	if (IS_SPARSE_AF(af) || af->size > AF_FIXED_WIDTH_MAX_SIZE)
+		return(0);
+	if (af->size <= FIXED_WIDTH_CAPACITY(1))
+		return(1);
+	if (af->size <= FIXED_WIDTH_CAPACITY(2))
+		return(2);
+	if (af->size <= FIXED_WIDTH_CAPACITY(4))
+		return(4);
+	return(8);
+}
+
+#define DEFINE_FIXED_WIDTH_AF(W)													\
+																					\
+typedef struct {																	\
+	SIZE_TYPE size;																	\
+	/* the arguments 0 ... size - 1 */												\
+	BitSet##W all;																	\
+	BitSet##W graph[FIXED_WIDTH_CAPACITY(W)];										\
+	BitSet##W attacked_by[FIXED_WIDTH_CAPACITY(W)];									\
+} AF##W;																			\
+																					\
+/* af has at most FIXED_WIDTH_CAPACITY(W) arguments */								\
+static inline void load_af##W(AF* af, AF##W* r) {									\
+	r->size = af->size;																\
+	r->all = bitset##W##_first(af->size);											\
+	for (SIZE_TYPE i = 0; i < af->size; ++i) {										\
+		r->graph[i] = bitset##W##_load(af->graph[i]);								\
+		r->attacked_by[i] = bitset##W##_empty();									\
+	}																				\
+	SIZE_TYPE j;																	\
+	for (SIZE_TYPE i = 0; i < af->size; ++i)										\
+		FOR_EACH_FIXED_WIDTH_BIT(W, r->graph[i], j)									\
+			FIXED_WIDTH_SET_BIT(r->attacked_by[j], i);								\
+}																					\
+																					\
+/* r without the rows of the elements of s */										\
+static inline BitSet##W minus_rows##W(BitSet##W r, const BitSet##W* rows,			\
+		BitSet##W s) {																\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		for (BITSET_BASE_TYPE w = s.words[k]; w; w &= w - 1) {						\
+			const BITSET_BASE_TYPE* row =											\
+				rows[k * BITSET_BASE_SIZE + __builtin_ctzll(w)].words;				\
+			FOR_EACH_FIXED_WIDTH_WORD(W, l)										\
+				r.words[l] &= ~row[l];												\
+		}																			\
+	return(r);																		\
+}																					\
+																					\
+/* the arguments attacked by no element of s */										\
+static inline BitSet##W complement_up_arrow##W(AF##W* af, BitSet##W s) {			\
+	return(minus_rows##W(af->all, af->graph, s));									\
+}																					\
+																					\
+/* the arguments attacking no element of s */										\
+static inline BitSet##W complement_down_arrow##W(AF##W* af, BitSet##W s) {			\
+	return(minus_rows##W(af->all, af->attacked_by, s));								\
+}																					\
+																					\
+static inline BitSet##W complement_down_up_arrow##W(AF##W* af, BitSet##W s) {		\
+	return(complement_up_arrow##W(af, complement_down_arrow##W(af, s)));			\
+}
+
+DEFINE_FIXED_WIDTH_AF(1)
+DEFINE_FIXED_WIDTH_AF(2)
+DEFINE_FIXED_WIDTH_AF(4)
+DEFINE_FIXED_WIDTH_AF(8)
+
+#endif /* AF_AF_FIXED_WIDTH_H_ */
@@ -80,13 +80,12 @@ int *sort_af(AF *af, AF *s_af, enum sort_type criterion, enum sort_direction dir
 
 	int i,j;
 	int victim_count = 0, attacker_count = 0;
+	// the attacker counts are the row counts of the transpose
+	AF* attacked_by = HAS_ADJACENCY_LISTS(af) ? NULL : get_transpose_framework(af);
 	for (i = 0; i < af->size; ++i) {
 		index_value_pairs[i].index = i;
 		victim_count = count_bits(af->graph[i]);
-		attacker_count = 0;
-		for (j = 0; j < af->size; ++j)
-			if (TEST_BIT(af->graph[j], i))
-				++attacker_count;
+		attacker_count = attacked_by ? count_bits(attacked_by->graph[i]) : AF_ATTACKER_COUNT(af, i);
 
 		index_value_pairs[i].value = metric_function(victim_count, attacker_count);
 		// if (victim_count == 0)
@@ -94,6 +93,8 @@ int *sort_af(AF *af, AF *s_af, enum sort_type criterion, enum sort_direction dir
 		// index_value_pairs[i].value = ((double) victim_count) / (0.5 * attacker_count);
 		// index_value_pairs[i].value = ((double) attacker_count) + 2 *  victim_count;
     }
+	if (attacked_by)
+		release_derived_framework(attacked_by);
 
 	// sort the index-value pairs according to value
     if (direction == SORT_DESCENDING)
@@ -24,7 +24,9 @@
 
 #include "af/sort.h"
 #include "algorithms/dc.h"
+#include "algorithms/grounded_reduct.h"
 #include "algorithms/cbo/preferred.h"
+#include "algorithms/fcbo/fcbo.h"
 #include "algorithms/connected-components/scc.h"
 #include "algorithms/ideal/ideal.h"
 #include "algorithms/maximal-independent-sets/mis.h"
@@ -34,14 +36,11 @@
 #include "algorithms/norris/stable.h"
 #include "algorithms/nourine/stable.h"
 #include "algorithms/connected-components/cc.h"
+#include "algorithms/connected-components/wcc.h"
 #include "parser/af_parser.h"
 #include "utils/timer.h"
 
 
-enum alg_type {CBO, MIS, NEXT_CLOSURE, NORRIS, NORRIS_BU, NOURINE, SCC_MIS, WCC_MIS, SCC_NEXT_CLOSURE, SCC_NORRIS, WCC_NORRIS, SCC_NORRIS_BU, SCC_NOURINE, WCC_NOURINE, SUBGRAPH, SUBGRAPH_ADJ};
-enum prob_type {EE_ST, SE_ST, CE_ST, DC_ST, EE_PR, SE_PR, DC_PR, DS_PR, SE_ID, EE_CO, DC_CO};
-
-
 ListNode* ee_pr_scc_next_closure(AF* af)
 {
 	return ee_pr_scc(af, ee_pr_next_closure);
@@ -61,10 +60,14 @@ int main(int argc, char *argv[]) {
 	bool problem_flag = 0, algorithm_flag = 0, input_flag = 0, output_flag = 0, wrong_argument_flag = 0, verbose_flag = 0, sort_flag = 0, argument_flag = 0;
 	char *problem = "", *algorithm = "", *af_file_name = "", *output_file = "";
 	int sort_type = 0, sort_direction = 0, argument;
-	static char usage[] = "Usage: %s -l [cbo | max-independent-sets | next-closure | norris | norris-bu | nourine | scc-max-independent-sets | wcc-max-independent-sets | scc-next-closure | scc-norris | scc-norris-bu | wcc-norris | scc-nourine | wcc-nourine | subgraph] "
-					      "-p [SE-ST, EE-ST, DC-ST, EE-PR, SE-PR, DC-PR, DS-PR, SE-ID, EE-CO] -a argument -f input -o output\n";
+	size_t memory_budget = default_memory_budget();
+	static char usage[] = "Usage: %1$s -l [cbo | fcbo | max-independent-sets | next-closure | norris | norris-bu | nourine | scc-cbo | scc-max-independent-sets | wcc-max-independent-sets | scc-next-closure | scc-norris | scc-norris-bu | wcc-norris | scc-nourine | wcc-nourine | subgraph] "
+					      "-p [SE-ST, EE-ST, DC-ST, EE-PR, SE-PR, DC-PR, DS-PR, SE-ID, EE-CO, DC-CO] -a argument -f input -o output [-m memory budget in MB]\n"
+					      "       %1$s -p [SE-GR, DC-GR, DS-CO] -a argument -f input -o output [-m memory budget in MB]\n"
+					      "Frameworks that do not fit in the memory budget as a dense matrix are stored sparse, only EE-ST with wcc-mis, wcc-norris\n"
+					      "or wcc-nourine and SE-GR, DC-GR and DS-CO run on them.\n";
 
-	while ((c = getopt(argc, argv, "l:p:f:o:v:s:d:a:")) != -1)
+	while ((c = getopt(argc, argv, "l:p:f:o:v:s:d:a:m:")) != -1)
 		switch (c) {
 		case 'l':
 			algorithm_flag = 1;
@@ -96,18 +99,26 @@ int main(int argc, char *argv[]) {
 			argument_flag = 1;
 			argument = atoi(optarg);
 			break;
+		case 'm':
+			memory_budget = (size_t) atol(optarg) << 20;
+			break;
 		case '?':
 			wrong_argument_flag = 1;
 			break;
 		}
-	if (wrong_argument_flag || !input_flag || !output_flag || !algorithm_flag || !problem_flag) {
+	if (wrong_argument_flag || !input_flag || !output_flag || !problem_flag) {
 		fprintf(stderr, usage, argv[0]);
 		exit(EXIT_FAILURE);
 	}
 
 	enum alg_type alg;
-	if (strcmp(algorithm, "cbo") == 0) {
+	if (!algorithm_flag) {
+		// only allowed for the grounded problems, checked below
+		alg = NO_ALGORITHM;
+	} else if (strcmp(algorithm, "cbo") == 0) {
 		alg = CBO;
+	} else if (strcmp(algorithm, "fcbo") == 0) {
+		alg = FCBO;
 	} else if (strcmp(algorithm, "mis") == 0) {
 		alg = MIS;
 	} else if (strcmp(algorithm, "next-closure") == 0) {
@@ -116,6 +127,8 @@ int main(int argc, char *argv[]) {
 		alg = NORRIS;
 	} else if (strcmp(algorithm, "nourine") == 0) {
 		alg = NOURINE;
+	} else if (strcmp(algorithm, "scc-cbo") == 0) {
+		alg = SCC_CBO;
 	} else if (strcmp(algorithm, "scc-mis") == 0) {
 		alg = SCC_MIS;
 	} else if (strcmp(algorithm, "wcc-mis") == 0) {
@@ -183,12 +196,35 @@ int main(int argc, char *argv[]) {
 			fprintf(stderr, usage, argv[0]);
 			exit(EXIT_FAILURE);
 		}
+	} else if (strcmp(problem, "DS-CO") == 0) {
+		prob = DS_CO;
+		if (!argument_flag) {
+			fprintf(stderr, usage, argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	} else if (strcmp(problem, "SE-GR") == 0) {
+		prob = SE_GR;
+	} else if (strcmp(problem, "DC-GR") == 0) {
+		prob = DC_GR;
+		if (!argument_flag) {
+			fprintf(stderr, usage, argv[0]);
+			exit(EXIT_FAILURE);
+		}
 	} else {
 		fprintf(stderr, "Unknown problem %s\n", problem);
 		fprintf(stderr, usage, argv[0]);
 		exit(EXIT_FAILURE);
 	}
 
+	// The grounded problems are solved without a search algorithm
+	bool grounded_problem = prob == SE_GR || prob == DC_GR || prob == DS_CO;
+	if (!algorithm_flag && !grounded_problem) {
+		fprintf(stderr, usage, argv[0]);
+		exit(EXIT_FAILURE);
+	}
+	if (algorithm_flag && grounded_problem)
+		fprintf(stderr, "Problem %s does not use an algorithm, -l %s is ignored.\n", problem, algorithm);
+
 	// open the af file
 	FILE* input_fd;
 	FILE* output;
@@ -199,11 +235,33 @@ int main(int argc, char *argv[]) {
 	START_TIMER(start_time);
 
 	// Read the file into an argumentation framework.
-	AF *input_af = read_af(input_fd);
+	AF *input_af = read_af_with_budget(input_fd, memory_budget);
 	fclose(input_fd);
+	// Derived frameworks (transpose, complement, conflicts) are cached up to
+	// the same budget.
+	set_af_cache_limit(memory_budget);
+
+	// The arguments are numbered from 1 in the input.
+	if (argument_flag && (argument < 1 || argument > input_af->size)) {
+		fprintf(stderr, "Argument %d is not in the framework of %u arguments.\n", argument, input_af->size);
+		fprintf(stderr, usage, argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	// Only the weakly connected component algorithms work on sparse frameworks,
+	// the components are projected to dense frameworks. The grounded extension
+	// is computed on the adjacency lists.
+	if (IS_SPARSE_AF(input_af) && (sort_flag || (prob != EE_ST && !grounded_problem) || (prob == EE_ST && alg != WCC_MIS && alg != WCC_NORRIS && alg != WCC_NOURINE))) {
+		fprintf(stderr, "The framework does not fit in the memory budget as a dense matrix.\n"
+				"Use -p EE-ST with wcc-mis, wcc-norris or wcc-nourine, a grounded problem, or a larger -m.\n");
+		exit(EXIT_FAILURE);
+	}
 
 	STOP_TIMER(stop_time);
 	printf("Parsing time: %.3f milisecs\n", TIME_DIFF(start_time, stop_time) / 1000);
+	if (verbose_flag) {
+		printf("Bitset kernels: %s\n", bitset_kernels_name());
+	}
 
 	// Sort the af
 	AF *af = input_af;
@@ -216,6 +274,62 @@ int main(int argc, char *argv[]) {
 	}
 	// TODO: free the input_af? Needed for mapping back the sorted af?
 
+	// Remove the arguments decided by the grounded extension. It is contained
+	// in every complete, preferred, stable and ideal extension, the arguments
+	// it attacks are in none, and the extensions of af are those of the
+	// undecided arguments with the grounded extension added. A query on a
+	// decided argument is answered by the grounded extension. The reduct is a
+	// dense framework, sparse ones are not reduced.
+	BitSet* grounded = NULL;
+	PAF* reduct = NULL;
+	bool decided = false;
+	bool query_problem = prob == DC_ST || prob == DC_CO || prob == DC_PR || prob == DS_PR;
+	// the argument in af, before it is renumbered in the reduct
+	int query = argument_flag ? argument : 0;
+	// the argument is in the grounded extension
+	bool accepted = false;
+	if (returns_extensions(prob, alg) && !IS_SPARSE_AF(af)) {
+		START_TIMER(start_time);
+		grounded = create_bitset(af->size);
+		BitSet* undecided = create_bitset(af->size);
+		grounded_extension(af, grounded, undecided);
+		BitSet* defeated = create_bitset(af->size);
+		copy_bitset(undecided, defeated);
+		bitset_union(undecided, grounded, undecided);
+		complement_bitset(undecided, undecided);
+		SIZE_TYPE undecided_count = count_bits(undecided);
+		STOP_TIMER(stop_time);
+		printf("Grounded extension: %u arguments, %u undecided, %.3f milisecs\n",
+				count_bits(grounded), undecided_count, TIME_DIFF(start_time, stop_time) / 1000);
+
+		accepted = query_problem && TEST_BIT(grounded, query - 1);
+		bool rejected = query_problem && TEST_BIT(defeated, query - 1);
+		free_bitset(defeated);
+		// a stable extension with an accepted argument still has to be found
+		// among the undecided ones, unless there are none
+		if ((!query_problem && undecided_count == 0) || rejected || (accepted && (prob != DC_ST || undecided_count == 0))) {
+			decided = true;
+		} else if (undecided_count > 0 && undecided_count < af->size) {
+			reduct = project_argumentation_framework(af, undecided);
+			if (query_problem && !accepted) {
+				// the index of the argument among the undecided ones
+				SIZE_TYPE i, rank = 0;
+				FOR_EACH_SET_BIT(undecided, i) {
+					if (i == argument - 1)
+						break;
+					++rank;
+				}
+				argument = rank + 1;
+			}
+			af = reduct->af;
+		}
+		free_bitset(undecided);
+		if (!reduct && !decided) {
+			free_bitset(grounded);
+			grounded = NULL;
+		}
+	}
+
 
 	if (verbose_flag) {
 		// print_short_stats(kb);
@@ -229,9 +343,28 @@ int main(int argc, char *argv[]) {
 
 	// TODO: Think about a matrix with pointers to relevant functions.
 	ListNode *result_list = NULL;
-	switch(prob) {
+	if (decided) {
+		BitSet* answer = query_problem ? grounded_answer(prob, grounded, query - 1) : grounded;
+		if (!answer) {
+			// DS-PR accepted and DC-PR without a witness print nothing
+			if (prob == DC_ST || prob == DC_CO)
+				fprintf(output, "NO\n");
+		}
+		else if (sort_flag) {
+			BitSet *x = map_indices(answer, mapping);
+			print_set(x, output, "\n");
+			free_bitset(x);
+		}
+		else {
+			print_set(answer, output, "\n");
+		}
+	}
+	else switch(prob) {
 		case EE_ST:
 			switch (alg) {
+				case FCBO:
+					result_list = ee_st_fcbo(af);
+					break;
 				case MIS:
 					result_list = ee_st_maximal_independent_sets(af);
 					break;
@@ -245,36 +378,38 @@ int main(int argc, char *argv[]) {
 					result_list = ee_st_nourine(af);
 					break;
 				case SCC_MIS:
-					run_cc_mis(af, output, true);
+					result_list = scc_stable_extensions(af, ee_st_maximal_independent_sets);
 					break;
 				case WCC_MIS:
-					run_cc_mis(af, output, false);
+					result_list = wcc_stable_extensions(af, ee_st_maximal_independent_sets);
 					break;
 				case SCC_NORRIS:
-					run_cc_norris(af, output, true);
+					result_list = scc_stable_extensions(af, ee_st_norris);
 					break;
 				case WCC_NORRIS:
-					run_cc_norris(af, output, false);
+					result_list = wcc_stable_extensions(af, ee_st_norris);
 					break;
 				case NORRIS_BU:
-					run_norris_bu(af, output);
+					result_list = enumerate_stable_extensions_norris_bottom_up(af);
 					break;
 				case SCC_NORRIS_BU:
-					run_cc_norris_bu(af, output, true);
+					result_list = scc_stable_extensions(af, enumerate_stable_extensions_norris_bottom_up);
 					break;
 				case SCC_NOURINE:
-					run_cc_nourine(af, output, true);
+					result_list = scc_stable_extensions(af, enumerate_stable_extensions_via_implications);
 					break;
 				case WCC_NOURINE:
-					run_cc_nourine(af, output, false);
+					result_list = wcc_stable_extensions(af, enumerate_stable_extensions_via_implications);
 					break;
 				case SCC_NEXT_CLOSURE:
-					run_cc_next_closure_st(af, output, true);
+					result_list = scc_stable_extensions(af, ee_st_next_closure);
 					break;
 			default:
 					fprintf(stderr, "Problem %s is not supported with algorithm %s.\n", problem, algorithm);
 					fclose(output);
 					exit(EXIT_FAILURE);			}
+			if (reduct)
+				lift_extensions(result_list, reduct, grounded);
 			if (sort_flag) {
 				ListNode* node = result_list;
 				while (node) {
@@ -292,11 +427,18 @@ int main(int argc, char *argv[]) {
 		case SE_ST: {
 			BitSet *result_se = create_bitset(af->size);
 			switch (alg) {
+				case FCBO:
+					se_st_fcbo(af, result_se);
+					break;
 				case NEXT_CLOSURE:
 					se_st_next_closure(af, result_se);
 					break;
 				case MIS:
+					free_bitset(result_se);
 					result_se = se_st_mis(af);
+					// NULL if there is no stable extension
+					if (!result_se)
+						result_se = create_bitset(af->size);
 					break;
 				case NORRIS:
 					// se = se_st_norris(af, output);
@@ -310,6 +452,9 @@ int main(int argc, char *argv[]) {
 					fclose(output);
 					exit(EXIT_FAILURE);
 			}
+			// the reduct is not empty, so an empty result means no extension
+			if (reduct && result_se && !bitset_is_emptyset(result_se))
+				result_se = lift_extension(result_se, reduct, grounded);
 			if (sort_flag) {
 				// map back the indices if af was sorted before
 				BitSet *x = map_indices(result_se, mapping);
@@ -326,18 +471,31 @@ int main(int argc, char *argv[]) {
 			// On the command line arguments are named starting from 1. Internally, they start from 0:
 			--argument;
 			BitSet *result_dc =  create_bitset(af->size);
+			// an accepted argument is in every stable extension of the reduct
+			// lifted, any one of them is a witness
 			switch (alg) {
 				case MIS:
-					result_dc = dc(af, argument, se_st_mis);
+					if (accepted) {
+						free_bitset(result_dc);
+						result_dc = se_st_mis(af);
+					}
+					else
+						result_dc = dc(af, argument, se_st_mis);
 					break;
 				case NEXT_CLOSURE:
-					dc_st_next_closure(af, argument, result_dc);
+					if (accepted)
+						se_st_next_closure(af, result_dc);
+					else
+						dc_st_next_closure(af, argument, result_dc);
 					break;
 				default:
 					fprintf(stderr, "Problem %s is not supported with algorithm %s.\n", problem, algorithm);
 					fclose(output);
 					exit(EXIT_FAILURE);
 			}
+			// the reduct is not empty, so an empty result means no witness
+			if (reduct && result_dc && !bitset_is_emptyset(result_dc))
+				result_dc = lift_witness(result_dc, reduct, grounded, query - 1);
 		    if (!result_dc || bitset_is_emptyset(result_dc)) {
 				// No stable extension containing argument
 			    fprintf(output, "NO\n");
@@ -378,23 +536,36 @@ int main(int argc, char *argv[]) {
 				default:
 					print_not_supported(problem, algorithm, output);				
 			}
+			if (reduct)
+				ideal = lift_extension(ideal, reduct, grounded);
 			print_set(ideal, output, "\n");
 			free_bitset(ideal);
 			free_argumentation_framework(af);}
 			break;
 		case EE_PR:
 			switch (alg) {
+				case CBO:
+					result_list = ee_pr_cbo(af);
+					break;
+				case FCBO:
+					result_list = ee_pr_fcbo(af);
+					break;
 				case NEXT_CLOSURE:
 					result_list = ee_pr_next_closure(af);
 					break;
+				case SCC_CBO:
+					result_list = ee_pr_scc(af, ee_pr_cbo);
+					break;
 				case SCC_NEXT_CLOSURE:
-					run_scc_next_closure(af, output);
+					result_list = ee_pr_scc_next_closure(af);
 					break;
 				default:
 					fprintf(stderr, "Problem %s is not supported with algorithm %s.\n", problem, algorithm);
 					fclose(output);
 					exit(EXIT_FAILURE);
 			}
+			if (reduct)
+				lift_extensions(result_list, reduct, grounded);
 			if (sort_flag) {
 				ListNode* node = result_list;
 				while (node) {
@@ -412,6 +583,8 @@ int main(int argc, char *argv[]) {
 		case SE_PR:
 			if (alg == CBO) {
 				BitSet* preferred = se_pr_cbo(af);
+				if (reduct)
+					preferred = lift_extension(preferred, reduct, grounded);
 				print_set(preferred, output, "\n");
 				free_bitset(preferred);
 			} else {
@@ -422,6 +595,8 @@ int main(int argc, char *argv[]) {
 			if (alg == CBO) {
 				BitSet* preferred = dc_pr_cbo_smart(af, --argument);
 				if (preferred) {
+					if (reduct)
+						preferred = lift_witness(preferred, reduct, grounded, query - 1);
 					print_set(preferred, output, "\n");
 					free_bitset(preferred);
 				}
@@ -433,6 +608,8 @@ int main(int argc, char *argv[]) {
 			if (alg == CBO) {
 				BitSet* preferred = ds_pr_cbo(af, --argument);
 				if (preferred) {
+					if (reduct)
+						preferred = lift_extension(preferred, reduct, grounded);
 					print_set(preferred, output, "\n");
 					free_bitset(preferred);
 				}
@@ -442,6 +619,9 @@ int main(int argc, char *argv[]) {
 			break;
 		case EE_CO:
 			switch (alg) {
+				case FCBO:
+					result_list = ee_co_fcbo(af);
+					break;
 				case NEXT_CLOSURE:
 					result_list = ee_co_next_closure(af);
 					break;
@@ -450,6 +630,8 @@ int main(int argc, char *argv[]) {
 					fclose(output);
 					exit(EXIT_FAILURE);
 			}
+			if (reduct)
+				lift_extensions(result_list, reduct, grounded);
 			if (sort_flag) {
 				ListNode* node = result_list;
 				while (node) {
@@ -483,40 +665,59 @@ int main(int argc, char *argv[]) {
 					// free_bitset(x);
 
 					result_dc = dc_co_next_closure_2(af, argument);
-					if (result_dc == NULL)
-						fprintf(output, "NO\n");
-					else {
-						print_set(result_dc, output, "\n");
-						free_bitset(result_dc);
-					}
 					break;
 				case SUBGRAPH:
 					result_dc = dc_co_subgraph_next_closure(af, argument);
-					if (result_dc == NULL)
-						fprintf(output, "NO\n");
-					else {
-						print_set(result_dc, output, "\n");
-						free_bitset(result_dc);
-					}
 					break;
 				case SUBGRAPH_ADJ:
 					result_dc = dc_co_subgraph_next_closure_adj(af, argument);
-					if (result_dc == NULL)
-						fprintf(output, "NO\n");
-					else {
-						print_set(result_dc, output, "\n");
-						free_bitset(result_dc);
-					}
 					break;
 				default:
 					fprintf(stderr, "Problem %s is not supported with algorithm %s.\n", problem, algorithm);
 					fclose(output);
 					exit(EXIT_FAILURE);
 			}
+			if (reduct && result_dc)
+				result_dc = lift_witness(result_dc, reduct, grounded, query - 1);
+			if (result_dc == NULL)
+				fprintf(output, "NO\n");
+			else {
+				print_set(result_dc, output, "\n");
+				free_bitset(result_dc);
+			}
+			break;
+		// The grounded extension is computed in polynomial time, the algorithm
+		// is not used. An argument is skeptically accepted under the complete
+		// semantics iff it is in the grounded extension.
+		case SE_GR:
+		case DC_GR:
+		case DS_CO: {
+			BitSet* result_gr = create_bitset(af->size);
+			BitSet* defeated = create_bitset(af->size);
+			grounded_extension(af, result_gr, defeated);
+			free_bitset(defeated);
+			if (prob == DS_CO) {
+				fprintf(output, TEST_BIT(result_gr, argument - 1) ? "YES\n" : "NO\n");
+			} else if (prob == DC_GR && !TEST_BIT(result_gr, argument - 1)) {
+				fprintf(output, "NO\n");
+			} else if (sort_flag) {
+				// map back the indices if af was sorted before
+				BitSet *x = map_indices(result_gr, mapping);
+				print_set(x, output, "\n");
+				free_bitset(x);
+			} else {
+				print_set(result_gr, output, "\n");
+			}
+			free_bitset(result_gr);
+			break;
+		}
 	}
 
 	STOP_TIMER(stop_time);
 	printf("Computation time: %.3f milisecs\n", TIME_DIFF(start_time, stop_time) / 1000);
+	printf("Derived frameworks: %zu built, %zu reused, %zu evicted, peak %.1f MB\n",
+			af_cache_stats.built, af_cache_stats.reused, af_cache_stats.evicted,
+			af_cache_stats.peak_bytes / (1024.0 * 1024.0));
 
 	// close the output file
 	fclose(output);
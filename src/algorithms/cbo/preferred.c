@@ -14,97 +14,54 @@
  * limitations under the License.
  */
 
-#include "preferred.h"
-
-BitSet* explore_subtree(BitSet* current, SIZE_TYPE m, AF* not_attacks, AF* af)
-{
-	BitSet* extension = 0;
-	BitSet* up = create_bitset(af->size);
-	up_arrow(not_attacks, current, up);
-	bool conflict_free = bitset_is_subset(current, up);
-
-	if (conflict_free) {
-		BitSet* next = create_bitset(af->size);
-
-		for (SIZE_TYPE i = m; i < af->size; ++i) {
-			if (!TEST_BIT(current, i) && 
-				!CHECK_ARG_ATTACKS_ARG(af, i, i) &&
-			  	!CHECK_ARG_ATTACKS_SET(af, i, current) &&
-			  	!check_set_attacks_arg(af, current, i)) {
-
-				SET_BIT(current, i);
-				down_up_arrow(not_attacks, current, next);
-				RESET_BIT(current, i);
-
-				bool good = true;
-				// is next canonical?
-				for (SIZE_TYPE j = 0; j < i; ++j) {
-					if (TEST_BIT(next, j) && !TEST_BIT(current, j)) {
-						good = false;
-						break;
-					}
-				}
-
-				if (good) {
-					// is next conflict-free?
-					for (SIZE_TYPE j = i + 1; j < af->size; ++j) {
-						if (TEST_BIT(next, j) && CHECK_ARG_ATTACKS_SET(af, j, next)) {
-							// we don't check if current attacks j, since this is impossible
-							good = false;
-							break;
-						}
-					}
-				}
-
-				if (good) {
-					extension = explore_subtree(next, i + 1, not_attacks, af);
-					if (extension) {
-						break;
-					}
-				}
-			}
-		} // end for
+#include <stdlib.h>
+#include <assert.h>
 
-		if (!extension) {
-			down_arrow(not_attacks, current, next);
-			if (bitset_is_subset(up, next)) {
-				extension = current;
-			}
-		}
-
-		if (extension != next) {
-			free_bitset(next);
-		}
+#include "preferred.h"
+#include "../next-closure/next_closure.h"
+#include "../next-closure/preferred.h"
+
+// Smallest number of candidates whose closures are computed in a batch
+#ifndef CBO_MIN_BATCH
+#define CBO_MIN_BATCH	8
+#endif
+
+// Largest number of children of a node kept in the arena. The search keeps
+// at most this many bitsets per level, a node with more canonical children
+// closes the remaining candidates again in its next batch.
+#ifndef CBO_MAX_CHILDREN
+#define CBO_MAX_CHILDREN	16
+#endif
+
+static CbOFrame* get_cbo_frame(CbOSearch* search, SIZE_TYPE depth) {
+	CbOFrame* frame = &search->frames[depth];
+	if (!frame->current) {
+		frame->current = create_bitset(search->af->size);
+		frame->up = create_bitset(search->af->size);
 	}
-
-	free_bitset(up);
-	
-	return extension;
+	return(frame);
 }
 
-
-int select_best_attacker(BitSet* current, BitSet* processed, AF* not_attacks, AF* attacked_by)
+int select_best_attacker(BitSet* current, BitSet* processed, AF* af, AF* attacked_by, BitSetArena* arena)
 {
 	// Return an unattacked attacker of current
 	// that has the smallest number of attackers outside processed.
 	// If current has no such attackers, i.e., it is self-defending,
 	// return -1
 
-	BitSet* unattacked = create_bitset(current->size);
-	up_arrow(not_attacks, current, unattacked);
-
-	BitSet* nonattacking = create_bitset(current->size);
-	down_arrow(not_attacks, current, nonattacking);
+	size_t mark = bitset_arena_mark(arena);
+	BitSet* unattacked = bitset_arena_alloc(arena);
+	complement_up_arrow(af, current, unattacked);
 
-	BitSet* attackers = create_bitset(current->size);
+	BitSet* nonattacking = bitset_arena_alloc(arena);
+	complement_down_arrow_by_columns(attacked_by, current, nonattacking);
 
 	int best = -1;
-	SIZE_TYPE min_attackers = not_attacks->size + 1;
+	SIZE_TYPE min_attackers = af->size + 1;
 	for (SIZE_TYPE i = 0; i < current->size; ++i)
 	{
 		if (TEST_BIT(unattacked, i) && !TEST_BIT(nonattacking, i)) {
-			bitset_set_minus(attacked_by->graph[i], processed, attackers);
-			SIZE_TYPE k = count_bits(attackers);
+			SIZE_TYPE k = count_bits_set_minus(attacked_by->graph[i], processed);
 			if (k < min_attackers) {
 				min_attackers = k;
 				best = i;
@@ -114,81 +71,258 @@ int select_best_attacker(BitSet* current, BitSet* processed, AF* not_attacks, AF
 			}
 		}
 	}
-	free_bitset(unattacked);
-	free_bitset(nonattacking);
-	free_bitset(attackers);
+	bitset_arena_release(arena, mark);
 	return best;
 }
 
-BitSet* explore_subtree_smart(BitSet* current, BitSet* processed, AF* not_attacks, AF* af, AF* attacked_by)
-{
-	// Return maximal admissible superset of current
-	// or NULL if no admissible superset exists.
+// Start the node of frame, its current set (and for the smart search its
+// processed arguments) are set. m is the first argument the plain search tries.
+static void enter_cbo_node(CbOSearch* search, CbOFrame* frame, SIZE_TYPE m) {
+	++search->nodes;
+	frame->found = false;
+	if (search->smart) {
+		// select an unattacked attacker with the smallest number of unprocessed attackers
+		frame->attacker = select_best_attacker(frame->current, frame->up, search->af, search->attacked_by, search->arena);
+		frame->i = 0;
+	} else {
+		complement_up_arrow(search->af, frame->current, frame->up);
+		frame->i = m;
+		frame->mark = frame->child = frame->child_end = bitset_arena_mark(search->arena);
+	}
+}
 
-	// current must be conflict-free
-	// processed must contain (among others) current,
-	// all self-attacking arguments, and
-	// arguments in conflict with current
+// Close the next batch of candidates of a node of the plain search. The
+// canonical conflict-free closures are kept in the arena as the children of
+// the node, since the nodes below use the same batch, at most
+// CBO_MAX_CHILDREN of them. A few candidates are closed one at a time.
+static void close_cbo_candidates(CbOSearch* search, CbOFrame* frame) {
+	AF* af = search->af;
+	AF* attacked_by = search->attacked_by;
+	ClosureBatch* batch = search->batch;
+	BitSet* current = frame->current;
+
+	bitset_arena_release(search->arena, frame->mark);
+	batch->count = 0;
+	for (; frame->i < af->size && batch->count < BITSET_BASE_SIZE; ++frame->i) {
+		SIZE_TYPE i = frame->i;
+		if (!TEST_BIT(current, i) && can_add_argument(af, attacked_by, current, i)) {
+			batch->candidates[batch->count++] = i;
+		}
+	}
 
-	BitSet* extension = NULL;
-	BitSet* next = create_bitset(af->size);
-	BitSet* next_processed = create_bitset(af->size);
+	// is next canonical?
+	bool batched = batch->count >= CBO_MIN_BATCH;
+	BITSET_BASE_TYPE canonical = batch->count == 0 ? 0 : ~(BITSET_BASE_TYPE) 0 >> (BITSET_BASE_SIZE - batch->count);
+	if (batched) {
+		complement_down_up_arrow_batch(af, attacked_by, current, batch);
+		canonical = canonical_batch_closures(batch, current);
+	}
 
-	// select an unattacked attacker with the smallest number of unprocessed attackers
-	int attacker = select_best_attacker(current, processed, not_attacks, attacked_by);
-	for (SIZE_TYPE i = 0; i < af->size; ++i) {
+	SIZE_TYPE children = 0;
+	for (; canonical; canonical &= canonical - 1) {
+		SIZE_TYPE b = __builtin_ctzll(canonical);
+		if (children == CBO_MAX_CHILDREN) {
+			// the next batch starts at this candidate
+			frame->i = batch->candidates[b];
+			break;
+		}
+		size_t child_mark = bitset_arena_mark(search->arena);
+		BitSet* next = bitset_arena_alloc(search->arena);
+		bool good = true;
+		if (batched) {
+			get_batch_closure(batch, b, next);
+		} else {
+			SET_BIT(current, batch->candidates[b]);
+			complement_down_up_arrow_by_columns(af, attacked_by, current, search->down, next);
+			RESET_BIT(current, batch->candidates[b]);
+			good = bitset_set_minus_is_empty_below(next, current, batch->candidates[b]);
+		}
+
+		if (good) {
+			// is next conflict-free?
+			SIZE_TYPE j;
+			FOR_EACH_SET_BIT_FROM(next, j, batch->candidates[b] + 1) {
+				if (CHECK_ARG_ATTACKS_SET(af, j, next)) {
+					// we don't check if current attacks j, since this is impossible
+					good = false;
+					break;
+				}
+			}
+		}
+
+		if (good) {
+			++children;
+		} else {
+			bitset_arena_release(search->arena, child_mark);
+		}
+	}
 
+	frame->child = frame->mark;
+	frame->child_end = bitset_arena_mark(search->arena);
+}
+
+// Put the next child of a node of the smart search into the frame below it,
+// returns false if there is none left. The processed arguments of the child
+// are those of the node, the victims of the arguments added and the
+// attackers of the argument branched on.
+static bool next_smart_child(CbOSearch* search, CbOFrame* frame, CbOFrame* child) {
+	AF* af = search->af;
+	AF* attacked_by = search->attacked_by;
+	BitSet* current = frame->current;
+	BitSet* processed = frame->up;
+	BitSet* next = child->current;
+	BitSet* next_processed = child->up;
+
+	for (; frame->i < af->size; ++frame->i) {
+		SIZE_TYPE i = frame->i;
 		if (TEST_BIT(processed, i) ||
 			// if there is attacker, i must attack it
-			(attacker >= 0 && !CHECK_ARG_ATTACKS_ARG(af, i, attacker))) {
+			(frame->attacker >= 0 && !CHECK_ARG_ATTACKS_ARG(af, i, frame->attacker))) {
 			continue;
 		}
 
 		SET_BIT(current, i);
-		down_up_arrow(not_attacks, current, next);
+		complement_down_up_arrow_by_columns(af, attacked_by, current, search->down, next);
 		RESET_BIT(current, i);
 
 		copy_bitset(processed, next_processed);
 
 		bool good = true;
-		for (SIZE_TYPE j = 0; j < af->size; ++j) {
-			if (TEST_BIT(next, j) && !TEST_BIT(current, j)) {
-				if (TEST_BIT(processed, j) ||	// non-canonical?
-					CHECK_ARG_ATTACKS_SET(af, j, next)) { // conflicts?
-					good = false;
-					break;
-				} else {
-					bitset_union(next_processed, af->graph[j], next_processed);
-					SET_BIT(next_processed, j);
-				}
+		for (SIZE_TYPE j = bitset_next_set_minus_bit(next, current, 0); j < af->size; j = bitset_next_set_minus_bit(next, current, j + 1)) {
+			if (TEST_BIT(processed, j) ||	// non-canonical?
+				CHECK_ARG_ATTACKS_SET(af, j, next)) { // conflicts?
+				good = false;
+				break;
+			} else {
+				bitset_union(next_processed, af->graph[j], next_processed);
+				SET_BIT(next_processed, j);
 			}
 		}
 
+		// the children after this one do not add i
+		SET_BIT(processed, i);
+
 		if (good) {
 			// arguments attacking neither current nor i don't attack next
 			// so new attackers of next (compared to current) are among attackers of i
 			bitset_union(next_processed, attacked_by->graph[i], next_processed);
-			extension = explore_subtree_smart(next, next_processed, not_attacks, af, attacked_by);
-			if (extension) {
-				break;
-			}
+			++frame->i;
+			return(true);
 		}
+	}
+	return(false);
+}
 
-		SET_BIT(processed, i);
+// Go back from the current node to its parent, found tells if there is an
+// admissible set in the subtree of the node
+static void leave_cbo_node(CbOSearch* search, bool found) {
+	if (search->depth == 0) {
+		search->status = CBO_EXHAUSTED;
+		return;
+	}
+	--search->depth;
+	if (found) {
+		search->frames[search->depth].found = true;
 	}
+}
 
-	if (!extension && attacker < 0) {
-		// current is admissible, since it has no unattacked attackers
-		extension = current;
+CbOSearch* create_cbo_search(AF* af, BitSet* start, BitSet* processed) {
+	CbOSearch* search = (CbOSearch*) calloc(1, sizeof(CbOSearch));
+	assert(search != NULL);
+	search->af = af;
+	search->attacked_by = get_transpose_framework(af);
+	search->smart = processed != NULL;
+	search->frames = (CbOFrame*) calloc(af->size + 1, sizeof(CbOFrame));
+	assert(search->frames != NULL);
+	search->status = CBO_SUSPENDED;
+	search->down = create_bitset(af->size);
+	search->batch = search->smart ? NULL : create_closure_batch(af->size);
+	search->arena = create_bitset_arena(af->size);
+
+	CbOFrame* root = get_cbo_frame(search, 0);
+	copy_bitset(start, root->current);
+	if (search->smart) {
+		copy_bitset(processed, root->up);
+	}
+	enter_cbo_node(search, root, 0);
+	// the searches check the children for conflicts, not the root. The
+	// closure of an argument may have one, then no admissible set contains it.
+	if (search->smart ? !is_set_conflict_free(af, root->current) : !bitset_is_subset(root->current, root->up)) {
+		search->status = CBO_EXHAUSTED;
 	}
+	return(search);
+}
 
-	if (extension != next) {
-		free_bitset(next);
+enum cbo_status run_cbo_search(CbOSearch* search, size_t budget) {
+	if (search->status == CBO_FOUND) {
+		// continue after the node reported, its ancestors are not reported
+		search->status = CBO_SUSPENDED;
+		leave_cbo_node(search, true);
 	}
 
-	free_bitset(next_processed);
+	size_t end = search->nodes + budget;
+	while (search->status == CBO_SUSPENDED) {
+		if (budget > 0 && search->nodes >= end) {
+			break;
+		}
 
-	return extension;
+		CbOFrame* frame = &search->frames[search->depth];
+		bool admissible;
+		if (search->smart) {
+			CbOFrame* child = get_cbo_frame(search, search->depth + 1);
+			if (next_smart_child(search, frame, child)) {
+				++search->depth;
+				enter_cbo_node(search, child, 0);
+				continue;
+			}
+			// current is admissible, if it has no unattacked attackers
+			admissible = frame->attacker < 0;
+		} else {
+			if (frame->child < frame->child_end) {
+				BitSet* next = bitset_arena_at(search->arena, frame->child++);
+				CbOFrame* child = get_cbo_frame(search, search->depth + 1);
+				copy_bitset(next, child->current);
+				// the candidate of a canonical closure is its first argument outside current
+				SIZE_TYPE candidate = bitset_next_set_minus_bit(next, frame->current, 0);
+				++search->depth;
+				enter_cbo_node(search, child, candidate + 1);
+				continue;
+			}
+			if (frame->i < search->af->size) {
+				close_cbo_candidates(search, frame);
+				continue;
+			}
+			bitset_arena_release(search->arena, frame->mark);
+			complement_down_arrow_by_columns(search->attacked_by, frame->current, search->down);
+			admissible = bitset_is_subset(frame->up, search->down);
+		}
+
+		// the node is reported if no child has an admissible superset
+		if (admissible && !frame->found) {
+			search->extension = frame->current;
+			search->status = CBO_FOUND;
+		} else {
+			leave_cbo_node(search, admissible || frame->found);
+		}
+	}
+	return(search->status);
+}
+
+void free_cbo_search(CbOSearch* search) {
+	for (SIZE_TYPE d = 0; d <= search->af->size; ++d) {
+		if (search->frames[d].current) {
+			free_bitset(search->frames[d].current);
+			free_bitset(search->frames[d].up);
+		}
+	}
+	free(search->frames);
+	free_bitset(search->down);
+	if (search->batch) {
+		free_closure_batch(search->batch);
+	}
+	free_bitset_arena(search->arena);
+	release_derived_framework(search->attacked_by);
+	free(search);
 }
 
 BitSet* dc_pr_cbo(AF* af, SIZE_TYPE a)
@@ -197,45 +331,39 @@ BitSet* dc_pr_cbo(AF* af, SIZE_TYPE a)
 		return 0;
 	}
 
-	AF* not_attacks = complement_argumentation_framework(af);
-
 	BitSet* c = create_bitset(af->size);
-	//copy_bitset(not_attacks->graph[a], c); ---TODO: This doesn't work as intended!
-	//										 ---TODO: It should now (after changes in complement_bitset).
 	set_bitset(c);
 	for (SIZE_TYPE i = 0; i < af->size; ++i) {
 		if (a == af->size || !CHECK_ARG_ATTACKS_ARG(af, i, a)) {
-	        bitset_intersection(c, not_attacks->graph[i], c);
+	        bitset_set_minus(c, af->graph[i], c);
 		}
 	}
     // c is the closure of {a} if a >= 0 or of {} otherwise
 
-	BitSet* extension = explore_subtree(c, 0, not_attacks, af);
-
-	if (extension != c) {
+	CbOSearch* search = create_cbo_search(af, c, NULL);
+	BitSet* extension = NULL;
+	if (run_cbo_search(search, 0) == CBO_FOUND) {
+		// copy the extension out of the search
+		copy_bitset(search->extension, c);
+		extension = c;
+	} else {
 		free_bitset(c);
 	}
-	free_argumentation_framework(not_attacks);
+	free_cbo_search(search);
 
     return extension;
 }
 
 
-BitSet* dc_pr_cbo_smart(AF* af, SIZE_TYPE a)
+// The closure of {a} if a < af->size or of {} otherwise, the root of the
+// smart search. processed receives its processed arguments.
+static BitSet* smart_search_start(AF* af, SIZE_TYPE a, BitSet* processed)
 {
-	// printf("smart\n");
-	if (a < af->size && CHECK_ARG_ATTACKS_ARG(af, a, a)) {
-		return NULL;
-	}
-
-	AF* not_attacks = complement_argumentation_framework(af);
-	BitSet* processed = create_bitset(af->size);
-
 	BitSet* c = create_bitset(af->size);
 	set_bitset(c);
 	for (SIZE_TYPE i = 0; i < af->size; ++i) {
 		if (a == af->size || !CHECK_ARG_ATTACKS_ARG(af, i, a)) {
-			bitset_intersection(c, not_attacks->graph[i], c);
+			bitset_set_minus(c, af->graph[i], c);
 			if (CHECK_ARG_ATTACKS_ARG(af, i, i)) {
 				SET_BIT(processed, i);	// self-attacking arguments
 			}
@@ -247,23 +375,36 @@ BitSet* dc_pr_cbo_smart(AF* af, SIZE_TYPE a)
 	// (recall that preferred extensions are closed)
 
 	bitset_union(c, processed, processed);	// c is contained in processed
-	for (SIZE_TYPE i = 0; i < af->size; ++i) {
-		if (TEST_BIT(c, i)) {
-			// add arguments attacked by c
-			bitset_union(processed, af->graph[i], processed);
-		}
+	SIZE_TYPE i;
+	FOR_EACH_SET_BIT(c, i) {
+		// add arguments attacked by c
+		bitset_union(processed, af->graph[i], processed);
 	}
+	return c;
+}
 
-	AF* attacked_by = transpose_argumentation_framework(af);
-	BitSet* extension = explore_subtree_smart(c, processed, not_attacks, af, attacked_by);
 
-	if (extension != c) {
-		free_bitset(c);
+BitSet* dc_pr_cbo_smart(AF* af, SIZE_TYPE a)
+{
+	// printf("smart\n");
+	if (a < af->size && CHECK_ARG_ATTACKS_ARG(af, a, a)) {
+		return NULL;
 	}
 
+	BitSet* processed = create_bitset(af->size);
+	BitSet* c = smart_search_start(af, a, processed);
+
+	CbOSearch* search = create_cbo_search(af, c, processed);
+	BitSet* extension = NULL;
+	if (run_cbo_search(search, 0) == CBO_FOUND) {
+		// copy the extension out of the search
+		copy_bitset(search->extension, c);
+		extension = c;
+	} else {
+		free_bitset(c);
+	}
+	free_cbo_search(search);
 	free_bitset(processed);
-	free_argumentation_framework(not_attacks);
-	free_argumentation_framework(attacked_by);
 
 	return extension;
 }
@@ -299,3 +440,28 @@ BitSet* se_pr_cbo(AF* af)
 	return dc_pr_cbo_smart(af, af->size);
 	// return dc_pr_cbo(af, af->size);
 }
+
+
+ListNode* ee_pr_cbo(AF* af)
+{
+	BitSet* processed = create_bitset(af->size);
+	BitSet* c = smart_search_start(af, af->size, processed);
+
+	// the unattacked arguments are admissible, so there is at least one set
+	ListNode* extensions = NULL;
+	CbOSearch* search = create_cbo_search(af, c, processed);
+	while (run_cbo_search(search, 0) == CBO_FOUND) {
+		BitSet* candidate = create_bitset(af->size);
+		copy_bitset(search->extension, candidate);
+		extensions = add_candidate(extensions, candidate);
+		if (extensions->c != candidate) {
+			// a superset is in the list already
+			free_bitset(candidate);
+		}
+	}
+	free_cbo_search(search);
+	free_bitset(c);
+	free_bitset(processed);
+
+	return extensions;
+}
@@ -18,10 +18,86 @@
 #define AF_PREFERRED_EXTENSIONS_CBO_H_
 
 #include "../../af/af.h"
+#include "../../bitset/bitset_arena.h"
+#include "../../utils/linked_list.h"
+
+// Close-by-One search for the preferred extensions containing a given closed
+// set, on an explicit stack of frames, one per depth. A depth is at most the
+// number of arguments, since every child adds an argument. The search runs
+// in steps of a given number of nodes, so that a caller can stop it on a
+// time budget and resume it later.
+//
+// A node is reported if its set is admissible and no admissible set was
+// found below it. The first one is a preferred extension. Every preferred
+// extension is reported once the search is exhausted, but so are admissible
+// sets that are only maximal in their own subtree.
+//
+// The plain search tries the arguments after the last one added, in batches
+// of closures (see ClosureBatch). The smart search branches on the arguments
+// attacking an undefended attacker of the current set and skips the
+// processed arguments: the current set, the arguments in conflict with it,
+// the self-attacking ones and the ones already tried on the path.
+
+enum cbo_status {CBO_FOUND, CBO_EXHAUSTED, CBO_SUSPENDED};
+
+typedef struct cbo_frame CbOFrame;
+
+struct cbo_frame {
+	BitSet* current;
+	// plain: complement_up_arrow(af, current), smart: the processed arguments
+	BitSet* up;
+	// next argument to try
+	SIZE_TYPE i;
+	// smart: the attacker to branch on, -1 if current is admissible
+	int attacker;
+	// an admissible set was found below the node
+	bool found;
+	// plain: the arena positions of the children of the last batch that are
+	// not explored yet, and the mark to release them
+	size_t child;
+	size_t child_end;
+	size_t mark;
+};
+
+typedef struct cbo_search CbOSearch;
+
+struct cbo_search {
+	AF* af;
+	AF* attacked_by;
+	bool smart;
+	// af->size + 1 frames, the bitsets are created on first use
+	CbOFrame* frames;
+	SIZE_TYPE depth;
+	enum cbo_status status;
+	// the extension found, valid until the search is continued or freed
+	BitSet* extension;
+	// number of nodes visited
+	size_t nodes;
+	BitSet* down;
+	ClosureBatch* batch;
+	BitSetArena* arena;
+};
+
+// Start a search for a preferred extension containing start, a closed set.
+// processed is NULL for the plain search, otherwise the processed arguments
+// of start for the smart search. start and processed are copied.
+CbOSearch* create_cbo_search(AF* af, BitSet* start, BitSet* processed);
+
+// Continue the search for at most budget nodes, without limit if budget is 0.
+// Returns CBO_FOUND with the next set reported in search->extension, or
+// CBO_SUSPENDED if the budget is used up. In both cases another call
+// continues the search.
+enum cbo_status run_cbo_search(CbOSearch* search, size_t budget);
+
+void free_cbo_search(CbOSearch* search);
 
 BitSet* dc_pr_cbo(AF* af, SIZE_TYPE a);
 BitSet* dc_pr_cbo_smart(AF* af, SIZE_TYPE a);
 BitSet* ds_pr_cbo(AF* af, SIZE_TYPE a);
 BitSet* se_pr_cbo(AF* af);
 
+// Computes all preferred extensions with the smart search, the sets it
+// reports are filtered for maximality
+ListNode* ee_pr_cbo(AF* af);
+
 #endif /* AF_PREFERRED_EXTENSIONS_CBO_H_ */
@@ -17,6 +17,7 @@
 #include <stdlib.h>
 
 #include "../../bitset/bitset.h"
+#include "../cbo/preferred.h"
 #include "../maximal-independent-sets/mis.h"
 #include "../next-closure/preferred.h"
 #include "../norris/stable.h"
@@ -85,6 +86,11 @@ void run_scc_next_closure(AF* af, FILE* output) {
 }
 
 
+void run_scc_cbo(AF* af, FILE* output) {
+	run_cc_preferred(af, ee_pr_cbo, output);
+}
+
+
 void run_cc_preferred(AF* af, ListNode* (*preferred_extensions)(AF* af), FILE* output) {
 	ListNode* head = ee_pr_scc(af, preferred_extensions);
 	ListNode* node = head;
@@ -36,5 +36,6 @@ void run_cc_next_closure_st(AF* af, FILE* output, bool scc);
 // preferred extensions
 void run_cc_preferred(AF* af, ListNode* (*preferred_extensions)(AF* af), FILE* output);
 void run_scc_next_closure(AF* af, FILE* output);
+void run_scc_cbo(AF* af, FILE* output);
 
 #endif //CC_H
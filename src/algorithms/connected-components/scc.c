@@ -1,36 +1,232 @@
+#include <string.h>
+#include <assert.h>
+
 #include "../../af/af.h"
 #include "../utils/linked_list.h"
 #include "../utils/map.h"
+#include "../../utils/stack.h"
+#include "scc.h"
 
 #ifndef MAP_SIZE
 #define MAP_SIZE 	101
 
 
-void dfs(AF* af, SIZE_TYPE i, BitSet* arguments, BitSet* visited) {
+// The backward search keeps its frontier in a stack instead of recursing, the
+// depth can be the number of arguments.
+void backward_dfs(AF* af,
+                  SIZE_TYPE i,
+                  BitSet* arguments, 
+                  BitSet* visited) {
+    // without attacker lists the attackers are the rows of the transpose
+    AF* attacked_by = HAS_ADJACENCY_LISTS(af) ? NULL : get_transpose_framework(af);
+    Stack stack;
+    init_stack(&stack);
     SET_BIT(visited, i);
-    // assume that vertex 0 is already visited
-    for (SIZE_TYPE j = 1; j < af->size; ++j) { 
-        if (TEST_BIT(arguments, j) && 
-            !TEST_BIT(visited, j) && 
-            TEST_BIT(af->graph[i], j)) {
-            dfs(af, j, arguments, visited);
+    push(&stack, i);
+    while (stack.size > 0) {
+        i = pop(&stack);
+        SIZE_TYPE j;
+        if (attacked_by) {
+            FOR_EACH_SET_BIT(attacked_by->graph[i], j) {
+                if (TEST_BIT(arguments, j) && !TEST_BIT(visited, j)) {
+                    SET_BIT(visited, j);
+                    push(&stack, j);
+                }
+            }
+            continue;
+        }
+        FOR_EACH_ATTACKER(af, i, j) {
+            if (TEST_BIT(arguments, j) && !TEST_BIT(visited, j)) {
+                SET_BIT(visited, j);
+                push(&stack, j);
+            }
         }
     }
+    free_stack(&stack);
+    if (attacked_by)
+        release_derived_framework(attacked_by);
 }
 
 
-void backward_dfs(AF* af,
-                  SIZE_TYPE i,
-                  BitSet* arguments, 
-                  BitSet* visited) {
-    SET_BIT(visited, i);
-    for (SIZE_TYPE j = 0; j < af->size; ++j) {
-        if (TEST_BIT(arguments, j) && 
-            !TEST_BIT(visited, j) && 
-            TEST_BIT(af->graph[j], i)) {
-            backward_dfs(af, j, arguments, visited);
+// The next victim of i in arguments at or after position *pos of its
+// adjacency list, or of its row if af has no lists. af->size if there is none.
+static SIZE_TYPE next_victim(AF* af, BitSet* arguments, SIZE_TYPE i, size_t* pos) {
+    if (HAS_ADJACENCY_LISTS(af)) {
+        while (*pos < af->victim_offsets[i + 1]) {
+            SIZE_TYPE j = af->victims[(*pos)++];
+            if (TEST_BIT(arguments, j))
+                return j;
+        }
+        return af->size;
+    }
+    SIZE_TYPE j = bitset_next_set_bit(af->graph[i], *pos);
+    while (j < af->size && !TEST_BIT(arguments, j))
+        j = bitset_next_set_bit(af->graph[i], j + 1);
+    *pos = j + 1;
+    return j;
+}
+
+
+// The work arrays of the Pearce pass. rindex is indexed by the arguments of
+// af and is 0 outside of a pass, the other arrays hold at most one entry per
+// argument the pass runs on.
+struct scc_work {
+    SIZE_TYPE* rindex;
+    // the call stack, the position of each call in the victims of its
+    // argument and whether it is the root of a component so far
+    SIZE_TYPE* calls;
+    size_t* pos;
+    bool* root;
+    // the visited arguments without a component
+    SIZE_TYPE* pending;
+};
+
+
+static void init_scc_work(SCCWork* work, SIZE_TYPE size, SIZE_TYPE capacity) {
+    work->rindex = calloc(size, sizeof(SIZE_TYPE));
+    work->calls = malloc(capacity * sizeof(SIZE_TYPE));
+    work->pos = malloc(capacity * sizeof(size_t));
+    work->root = malloc(capacity * sizeof(bool));
+    work->pending = malloc(capacity * sizeof(SIZE_TYPE));
+    assert(work->rindex && work->calls && work->pos && work->root && work->pending);
+}
+
+
+static void push_call(AF* af, SCCWork* work, SIZE_TYPE* call_count, SIZE_TYPE i) {
+    work->calls[*call_count] = i;
+    work->pos[*call_count] = HAS_ADJACENCY_LISTS(af) ? af->victim_offsets[i] : 0;
+    work->root[*call_count] = true;
+    ++*call_count;
+}
+
+
+// Pearce's variant of Tarjan's algorithm with an explicit call stack, one
+// pass over the attacks of the count arguments in arguments. rindex[i] is the
+// visiting order of i while i is on the stacks and the component number once
+// its component is complete. The component numbers count down from count so
+// that they are larger than every visiting order in use, the first completed
+// component is a sink of the condensation and the last one a source. Returns
+// the number below the last component.
+static SIZE_TYPE number_components(AF* af, BitSet* arguments, SIZE_TYPE count, SCCWork* work) {
+    SIZE_TYPE n = af->size;
+    SIZE_TYPE* rindex = work->rindex;
+    SIZE_TYPE call_count = 0, pending_count = 0;
+    SIZE_TYPE index = 1, c = count;
+
+    SIZE_TYPE s;
+    FOR_EACH_SET_BIT(arguments, s) {
+        if (rindex[s])
+            continue;
+        rindex[s] = index++;
+        push_call(af, work, &call_count, s);
+        while (call_count > 0) {
+            SIZE_TYPE k = call_count - 1;
+            SIZE_TYPE i = work->calls[k];
+            SIZE_TYPE j = next_victim(af, arguments, i, &work->pos[k]);
+            if (j < n) {
+                if (!rindex[j]) {
+                    rindex[j] = index++;
+                    push_call(af, work, &call_count, j);
+                } else if (rindex[j] < rindex[i]) {
+                    rindex[i] = rindex[j];
+                    work->root[k] = false;
+                }
+                continue;
+            }
+            // all victims of i are done, return to the caller
+            --call_count;
+            if (work->root[k]) {
+                --index;
+                while (pending_count > 0 && rindex[i] <= rindex[work->pending[pending_count - 1]]) {
+                    rindex[work->pending[--pending_count]] = c;
+                    --index;
+                }
+                rindex[i] = c--;
+            } else
+                work->pending[pending_count++] = i;
+            if (call_count > 0) {
+                SIZE_TYPE caller = work->calls[k - 1];
+                if (rindex[i] < rindex[caller]) {
+                    rindex[caller] = rindex[i];
+                    work->root[k - 1] = false;
+                }
+            }
+        }
+    }
+    return c;
+}
+
+
+// The work arrays are sized by the arguments, rindex becomes component_of and
+// pending the members.
+Condensation* compute_condensation(AF* af, BitSet* arguments) {
+    SIZE_TYPE n = af->size, count = count_bits(arguments);
+    SCCWork work;
+    init_scc_work(&work, n, count > 0 ? count : 1);
+    SIZE_TYPE c = number_components(af, arguments, count, &work);
+    free(work.calls);
+    free(work.pos);
+    free(work.root);
+
+    // renumber the components in topological order and sort the arguments
+    // by component
+    SIZE_TYPE* rindex = work.rindex;
+    Condensation* condensation = malloc(sizeof(Condensation));
+    assert(condensation);
+    condensation->count = count - c;
+    condensation->component_of = rindex;
+    condensation->offsets = calloc(condensation->count + 1, sizeof(SIZE_TYPE));
+    condensation->members = work.pending;
+    condensation->splits = NULL;
+    condensation->split_work = NULL;
+    assert(condensation->offsets);
+    for (SIZE_TYPE i = 0; i < n; ++i)
+        if (TEST_BIT(arguments, i)) {
+            rindex[i] -= c + 1;
+            ++condensation->offsets[rindex[i] + 1];
+        } else
+            rindex[i] = n;
+    for (SIZE_TYPE k = 0; k < condensation->count; ++k)
+        condensation->offsets[k + 1] += condensation->offsets[k];
+    SIZE_TYPE* next = malloc((condensation->count > 0 ? condensation->count : 1) * sizeof(SIZE_TYPE));
+    assert(next);
+    memcpy(next, condensation->offsets, condensation->count * sizeof(SIZE_TYPE));
+    SIZE_TYPE s;
+    FOR_EACH_SET_BIT(arguments, s)
+        condensation->members[next[rindex[s]]++] = s;
+    free(next);
+    return condensation;
+}
+
+
+void free_condensation(Condensation* condensation) {
+    if (condensation->splits) {
+        BitSetHashMapElement* element = BITSET_HASH_MAP_LAST_ELEMENT(condensation->splits);
+        for (; element; element = BITSET_HASH_MAP_PREVIOUS_ELEMENT(element)) {
+            free_bitset(element->key);
+            free_bitset(element->value);
         }
+        MAP_FREE(condensation->splits);
     }
+    if (condensation->split_work) {
+        SCCWork* work = condensation->split_work;
+        free(work->rindex);
+        free(work->calls);
+        free(work->pos);
+        free(work->root);
+        free(work->pending);
+        free(work);
+    }
+    free(condensation->component_of);
+    free(condensation->offsets);
+    free(condensation->members);
+    free(condensation);
+}
+
+
+void get_component_mask(Condensation* condensation, SIZE_TYPE k, BitSet* mask) {
+    for (SIZE_TYPE p = condensation->offsets[k]; p < condensation->offsets[k + 1]; ++p)
+        SET_BIT(mask, condensation->members[p]);
 }
 
 
@@ -38,19 +234,79 @@ void backward_dfs(AF* af,
 // arguments must be non-empty
 // component must be empty
 void find_source_component(AF* af, BitSet* arguments, BitSet* component) {
-    // find a vertex in a source component
-    SIZE_TYPE source;
-    for (SIZE_TYPE i = 0; i < af->size; ++i) {
-        if (TEST_BIT(arguments, i) && !TEST_BIT(component, i)) {
-            source = i;
-            dfs(af, i, arguments, component);
-        }
+    Condensation* condensation = compute_condensation(af, arguments);
+    get_component_mask(condensation, 0, component);
+    free_condensation(condensation);
+}
+
+
+// The source component of rest, the count remaining arguments of a
+// component of condensation. The Pearce pass runs on the work arrays of the
+// condensation, which are sized for its largest component, and clears rindex
+// on rest again.
+static void find_split_source_component(AF* af,
+                                        Condensation* condensation,
+                                        BitSet* rest,
+                                        SIZE_TYPE count,
+                                        BitSet* source) {
+    if (!condensation->split_work) {
+        SIZE_TYPE capacity = 1;
+        for (SIZE_TYPE k = 0; k < condensation->count; ++k)
+            if (condensation->offsets[k + 1] - condensation->offsets[k] > capacity)
+                capacity = condensation->offsets[k + 1] - condensation->offsets[k];
+        condensation->split_work = malloc(sizeof(SCCWork));
+        assert(condensation->split_work);
+        init_scc_work(condensation->split_work, af->size, capacity);
+    }
+    SIZE_TYPE* rindex = condensation->split_work->rindex;
+    SIZE_TYPE c = number_components(af, rest, count, condensation->split_work);
+    SIZE_TYPE i;
+    FOR_EACH_SET_BIT(rest, i) {
+        if (rindex[i] == c + 1)
+            SET_BIT(source, i);
+        rindex[i] = 0;
     }
+}
 
-    // extract the component containing source
-    // printf("Source vertex: %d\n", source);
-    reset_bitset(component);
-    backward_dfs(af, source, arguments, component);
+
+// A residual subframework is the subframework of its parent without some
+// arguments, a component of the parent that lost none of them is still
+// strongly connected. Only a component that lost some is split again, the
+// branches of the search reach the same remaining arguments of a component
+// many times and take the split from condensation->splits.
+void find_remaining_source_component(AF* af,
+                                     Condensation* condensation,
+                                     SIZE_TYPE* first,
+                                     BitSet* arguments,
+                                     BitSet* component) {
+    for (; *first < condensation->count; ++*first) {
+        SIZE_TYPE begin = condensation->offsets[*first], end = condensation->offsets[*first + 1];
+        SIZE_TYPE remaining = 0;
+        for (SIZE_TYPE p = begin; p < end; ++p)
+            remaining += TEST_BIT(arguments, condensation->members[p]) != 0;
+        if (remaining == 0)
+            continue;
+        if (remaining == end - begin) {
+            get_component_mask(condensation, *first, component);
+            return;
+        }
+        BitSet* rest = create_bitset(af->size);
+        for (SIZE_TYPE p = begin; p < end; ++p)
+            if (TEST_BIT(arguments, condensation->members[p]))
+                SET_BIT(rest, condensation->members[p]);
+        if (!condensation->splits)
+            condensation->splits = MAP_CREATE(MAP_SIZE);
+        BitSet* source = MAP_GET(rest, condensation->splits);
+        if (source) {
+            free_bitset(rest);
+        } else {
+            source = create_bitset(af->size);
+            find_split_source_component(af, condensation, rest, remaining, source);
+            MAP_PUT(rest, source, condensation->splits);
+        }
+        copy_bitset(source, component);
+        return;
+    }
 }
 
 
@@ -91,20 +347,25 @@ BitSet* extract_residual_arguments(AF* af, BitSet* arguments, BitSet* source_com
 }
 
 
-ListNode* get_component_extensions(AF* af,
+// The subframeworks are PAFViews on the framework of scc_stable_extensions,
+// only the source components handed to stable_extensions are copied, and
+// none if the component is the whole framework.
+ListNode* get_component_extensions(PAFView* view,
                                    BitSet* component, 
                                    ListNode* (*stable_extensions)(AF* af), 
                                    Map* subextensions) {
 
     ListNode* component_extension = MAP_GET(component, subextensions); 
     if (!component_extension) {
-        PAF* projection = project_argumentation_framework(af, component);
-        // printf("Arguments in source component: %d\n", projection->af->size);
-        component_extension = stable_extensions(projection->af);
-        if (projection->af->size < af->size) {
+        if (count_bits(component) == view->af->size) {
+            component_extension = stable_extensions(view->af);
+        } else {
+            PAF* projection = project_paf_view(view, component);
+            // printf("Arguments in source component: %d\n", projection->af->size);
+            component_extension = stable_extensions(projection->af);
             restore_base_indices(component_extension, projection);
+            free_projected_argumentation_framework(projection);
         }
-        free_projected_argumentation_framework(projection);
         // printf("PUT %llu, %d, %llu\n", get_key(component), subextensions->bucket_count, get_key(component) % subextensions->bucket_count);
         BitSet* key = create_bitset(component->size);
         copy_bitset(component, key);
@@ -116,26 +377,28 @@ ListNode* get_component_extensions(AF* af,
 }
 
 
-// compute the stable extensions in the subframework of af induced by arguments
-ListNode* compute_extensions(AF* af,
-                             BitSet* arguments, 
+// compute the stable extensions in view, it has no arguments in the
+// components of condensation before first
+ListNode* compute_extensions(PAFView* view,
                              ListNode* (*stable_extensions)(AF* af),
-                             Map* subextensions) {
-    // printf("\nARGUMENTS: %d\n", count_bits(arguments)); 
-    // log_set(arguments);
+                             Map* subextensions,
+                             Condensation* condensation,
+                             SIZE_TYPE first) {
+    // printf("\nARGUMENTS: %d\n", view->size); 
+    // log_set(view->arguments);
     // printf("Hashed lists: %d\n", subextensions->element_count);
-    ListNode* first_extension = MAP_GET(arguments, subextensions);
+    ListNode* first_extension = MAP_GET(view->arguments, subextensions);
     if (first_extension) {
         // printf("Solution is taken from the hash\n");
         return first_extension;
     }
 
-    BitSet* component = create_bitset(af->size);
-    find_source_component(af, arguments, component);
+    BitSet* component = create_bitset(view->af->size);
+    find_remaining_source_component(view->af, condensation, &first, view->arguments, component);
     // printf("\nARGUMENTS in source component: %d\n", count_bits(component)); 
 
-    ListNode* component_extension = get_component_extensions(af, component, stable_extensions, subextensions);
-    if (count_bits(component) == count_bits(arguments)) {
+    ListNode* component_extension = get_component_extensions(view, component, stable_extensions, subextensions);
+    if (count_bits(component) == view->size) {
         free_bitset(component);
         return component_extension;
     }
@@ -146,16 +409,18 @@ ListNode* compute_extensions(AF* af,
     while (component_extension) {
         // printf("Arguments in component extension: %d\n", count_bits(component_extension->c));
         // log_set(component_extension->c);
-        BitSet* residual_arguments = extract_residual_arguments(af, arguments, component, component_extension->c);
+        BitSet* residual_arguments = extract_residual_arguments(view->af, view->arguments, component, component_extension->c);
         if (residual_arguments) {
             // printf("Residual arguments: %d\n", count_bits(residual_arguments));
-            ListNode* residual_extension = compute_extensions(af, residual_arguments, stable_extensions, subextensions);
-            // free_bitset(residual_arguments);
+            PAFView* residual_framework = restrict_paf_view(view, residual_arguments, NULL);
+            free_bitset(residual_arguments);
+            ListNode* residual_extension = compute_extensions(residual_framework, stable_extensions, subextensions, condensation, first);
+            free_paf_view(residual_framework);
 
             while (residual_extension) {
                 // printf("Component extension: ");
                 // log_set(residual_extension->c);
-                last_node->next = create_list_node(create_bitset(af->size));
+                last_node->next = create_list_node(create_bitset(view->af->size));
                 last_node = last_node->next;
                 bitset_union(component_extension->c, residual_extension->c, last_node->c);
                 // residual_extension = advance_and_free_extension(residual_extension);
@@ -175,7 +440,10 @@ ListNode* compute_extensions(AF* af,
 
     first_extension = head->next;
     free_list_node(head);
-    MAP_PUT(arguments, first_extension, subextensions);
+    // the lists of the map outlive the views, so do their keys
+    BitSet* key = create_bitset(view->af->size);
+    copy_bitset(view->arguments, key);
+    MAP_PUT(key, first_extension, subextensions);
     return first_extension;
 }
 
@@ -184,9 +452,11 @@ ListNode* scc_stable_extensions(AF* af, ListNode* (*stable_extensions)(AF* af))
     // maps a subset of arguments to a list of stable extensions of the induced argumentation subframework
     Map subextensions;
     MAP_INIT(&subextensions, MAP_SIZE);
-    BitSet* all_arguments = create_bitset(af->size);
-    set_bitset(all_arguments);
-    ListNode* first_extension = compute_extensions(af, all_arguments, stable_extensions, &subextensions);
+    PAFView* view = create_paf_view(af);
+    Condensation* condensation = compute_condensation(af, view->arguments);
+    ListNode* first_extension = compute_extensions(view, stable_extensions, &subextensions, condensation, 0);
+    free_condensation(condensation);
+    free_paf_view(view);
     // free_map_content(&subextensions);
     return first_extension;
 }
@@ -2,6 +2,7 @@
 #define AF_SCC_H_
 
 #include "../../af/af.h"
+#include "../../bitset/bitset_hash_map.h"
 #include "../../utils/linked_list.h"
 
 
@@ -12,7 +13,46 @@ size_t scc_count_stable_etensions(AF* af, ListNode* (*stable_extensions)(AF* af)
 ListNode* ee_pr_scc(AF* af, ListNode* (*preferred_extensions)(AF* af));
 
 void restore_base_indices(ListNode* node, PAF* paf);
+// The work arrays of the strongly connected components of a subframework
+typedef struct scc_work SCCWork;
+
+// The condensation of the subframework induced by some arguments: its strongly
+// connected components numbered in topological order, every attack between two
+// components goes from the smaller number to the larger one. component_of[i] is
+// the number of the component of i, af->size for arguments outside the
+// subframework. The arguments of component k are members[offsets[k]] ...
+// members[offsets[k + 1] - 1] in increasing order.
+typedef struct condensation {
+    SIZE_TYPE count;
+    SIZE_TYPE* component_of;
+    SIZE_TYPE* offsets;
+    SIZE_TYPE* members;
+    // The source components of the components that lost some of their
+    // arguments in a residual subframework, keyed by the remaining arguments
+    // of the component. NULL until the first split.
+    BitSetHashMap* splits;
+    // the work arrays of the splits, NULL until the first split
+    SCCWork* split_work;
+} Condensation;
+
+// Linear in the arguments and their attacks if af has adjacency lists.
+Condensation* compute_condensation(AF* af, BitSet* arguments);
+void free_condensation(Condensation* condensation);
+// Add the arguments of component k to mask.
+void get_component_mask(Condensation* condensation, SIZE_TYPE k, BitSet* mask);
+
 void find_source_component(AF* af, BitSet* arguments, BitSet* component);
+// Find a source component of the subframework induced by arguments, a subset
+// of the arguments of condensation without any in its components before
+// *first. *first is advanced to the component of condensation that contains
+// the result, the residual subframeworks of the result start there. A
+// component that lost some of its arguments is split once for each set of
+// remaining arguments, the split is kept in condensation.
+void find_remaining_source_component(AF* af,
+                                     Condensation* condensation,
+                                     SIZE_TYPE* first,
+                                     BitSet* arguments,
+                                     BitSet* component);
 BitSet* extract_residual_arguments(AF* af, BitSet* arguments, BitSet* source_component, BitSet* component_extension);
 
 void backward_dfs(AF* af, SIZE_TYPE i, BitSet* arguments, BitSet* visited);
@@ -39,19 +39,22 @@ ListNode* get_component_extensions_for_counting(AF* af,
 }
 
 
-// count the stable extensions in the subframework of af induced by arguments
+// count the stable extensions in the subframework of af induced by arguments,
+// it has no arguments in the components of condensation before first
 size_t count_extensions(AF* af,
                         BitSet* arguments, 
                         ListNode* (*stable_extensions)(AF* af), 
                         Map* subextensions,
-                        Map* subextension_counts) {
+                        Map* subextension_counts,
+                        Condensation* condensation,
+                        SIZE_TYPE first) {
     size_t* pcount = MAP_GET(arguments, subextension_counts);
     if (pcount) {
         return *pcount;
     }
 
     BitSet* component = create_bitset(af->size);
-    find_source_component(af, arguments, component);
+    find_remaining_source_component(af, condensation, &first, arguments, component);
 
     ListNode* component_extension = get_component_extensions_for_counting(af, 
                                                                           component,
@@ -70,7 +73,9 @@ size_t count_extensions(AF* af,
                                                     residual_arguments,
                                                     stable_extensions,
                                                     subextensions,
-                                                    subextension_counts) :
+                                                    subextension_counts,
+                                                    condensation,
+                                                    first) :
                                     1;
             if (residual_arguments) {
                 free_bitset(residual_arguments);
@@ -78,8 +83,8 @@ size_t count_extensions(AF* af,
             component_extension = component_extension->next;
         }
     }
+    // the extensions of the component stay in subextensions for later lookups
     free_bitset(component);
-    free_extension_list(component_extension);
 
     return n;
 }
@@ -92,5 +97,8 @@ size_t scc_count_stable_etensions(AF* af, ListNode* (*stable_extensions)(AF* af)
     MAP_INIT(&subextension_counts, MAP_SIZE);
     BitSet* all_arguments = create_bitset(af->size);
     set_bitset(all_arguments);
-    return count_extensions(af, all_arguments, stable_extensions, &subextensions, &subextension_counts);
+    Condensation* condensation = compute_condensation(af, all_arguments);
+    size_t n = count_extensions(af, all_arguments, stable_extensions, &subextensions, &subextension_counts, condensation, 0);
+    free_condensation(condensation);
+    return n;
 }
@@ -10,39 +10,28 @@
 #include "../utils/linked_list.h"
 
 
-void undirected_dfs(AF* af, int i, bool* visited, BitSet* component) {
-    SET_BIT(component, i);
-    visited[i] = true;
-    for (unsigned short j = 1; j < af->size; ++j) {
-        if (!visited[j] && (TEST_BIT(af->graph[i], j) || TEST_BIT(af->graph[j], i))) {
-            undirected_dfs(af, j, visited, component);
-        }
-    }
-}
-
-
-ListNode* wcc(AF* af, unsigned short* n) {
-    // components are stored in ListNodes
-    // each component is stored as a BitSet mask
-    bool visited[af->size];
-    for (unsigned short i = 0; i < af->size; ++i) {
-        visited[i] = false;
-    }
-    
+// The components are read from the labels of af, found by the parser or
+// else by a union-find over the attacks. Each component is stored in a
+// ListNode as a BitSet mask.
+ListNode* wcc(AF* af, SIZE_TYPE* n) {
+    build_weak_components(af);
+
+    // the label of a component is its smallest argument
+    BitSet** masks = (BitSet**) calloc(af->size > 0 ? af->size : 1, sizeof(BitSet*));
+    assert(masks != NULL);
     ListNode* first_component = NULL;
-    *n = 0;
-    
-    for (unsigned short i = 0; i < af->size; ++i) {
-        if (!visited[i]) {
-            BitSet* mask = create_bitset(af->size);
-            undirected_dfs(af, i, visited, mask);
-            ListNode* new_component = create_list_node(mask);
+    *n = af->component_count;
+    for (SIZE_TYPE i = 0; i < af->size; ++i) {
+        SIZE_TYPE root = af->component_of[i];
+        if (root == i) {
+            masks[i] = create_bitset(af->size);
+            ListNode* new_component = create_list_node(masks[i]);
             new_component->next = first_component;
-            // TODO: new_component->c is not set! Causes segmentation fault later.
             first_component = new_component;
-            (*n)++;
         }
+        SET_BIT(masks[root], i);
     }
+    free(masks);
     return first_component;
 }
 
@@ -58,8 +47,8 @@ void free_components(ListNode* first_component) {
 }
 
 
-void free_extension_lists(ListNode** extension_lists, unsigned short begin, unsigned short end){
-    for (unsigned short i = begin; i < end; ++i) {
+void free_extension_lists(ListNode** extension_lists, SIZE_TYPE begin, SIZE_TYPE end){
+    for (SIZE_TYPE i = begin; i < end; ++i) {
         ListNode* component_extension = extension_lists[i];
         while (component_extension) {
             ListNode* next = component_extension->next;
@@ -71,15 +60,15 @@ void free_extension_lists(ListNode** extension_lists, unsigned short begin, unsi
 }
 
 
-void free_projections(PAF** projections, unsigned short n) {
-    for (unsigned short i; i < n; ++i) {
+void free_projections(PAF** projections, SIZE_TYPE n) {
+    for (SIZE_TYPE i = 0; i < n; ++i) {
         free_projected_argumentation_framework(projections[i]);
     }
 }
 
 
-void restore_indices(ListNode** extension_lists, PAF** projections, unsigned short n, unsigned short base_size) {
-    for (int i = 0; i < n; ++i) {
+void restore_indices(ListNode** extension_lists, PAF** projections, SIZE_TYPE n, SIZE_TYPE base_size) {
+    for (SIZE_TYPE i = 0; i < n; ++i) {
         PAF* paf = projections[i];
         ListNode* node = extension_lists[i];
         while (node) {
@@ -93,23 +82,27 @@ void restore_indices(ListNode** extension_lists, PAF** projections, unsigned sho
 
 
 ListNode* wcc_stable_extensions(AF* af, ListNode* (*stable_extensions)(AF* af)) {
-    unsigned short n;
+    SIZE_TYPE n;
     ListNode* first_component = wcc(af, &n);
-    printf("Weakly connected components: %d\n", n);
-    ListNode* extension_lists[n];
-    PAF* projections[n];
+    printf("Weakly connected components: %u\n", n);
+    ListNode** extension_lists = (ListNode**) calloc(n > 0 ? n : 1, sizeof(ListNode*));
+    assert(extension_lists != NULL);
+    PAF** projections = (PAF**) calloc(n > 0 ? n : 1, sizeof(PAF*));
+    assert(projections != NULL);
 
     // compute "local" stable extensions in each component
     ListNode* component = first_component;
-    for (unsigned short i = 0; i < n; ++i) {
+    for (SIZE_TYPE i = 0; i < n; ++i) {
         projections[i] = project_argumentation_framework(af, component->c);
-        printf("Number of arguments in component %d: %d\n", i + 1, projections[i]->af->size);
+        printf("Number of arguments in component %u: %u\n", i + 1, projections[i]->af->size);
         extension_lists[i] = stable_extensions(projections[i]->af);
         if (!extension_lists[i]) {
             // there are no "global" stable extensions either
             free_projections(projections, i + 1);
             free_components(first_component);
             free_extension_lists(extension_lists, 0, i);
+            free(extension_lists);
+            free(projections);
             return NULL;
         }
 
@@ -123,7 +116,7 @@ ListNode* wcc_stable_extensions(AF* af, ListNode* (*stable_extensions)(AF* af))
     // form the unions of stable extensions from different components
     // and store the results in extension_lists[0]
     ListNode* res = extension_lists[0];
-    for (unsigned short i = 1; i < n; ++i) {
+    for (SIZE_TYPE i = 1; i < n; ++i) {
         // printf("Component %d\n", i);
         ListNode* cur = res;
         while (cur) {
@@ -152,6 +145,8 @@ ListNode* wcc_stable_extensions(AF* af, ListNode* (*stable_extensions)(AF* af))
 
     free_projections(projections, n);
     free_extension_lists(extension_lists, 1, n);
+    free(extension_lists);
+    free(projections);
 
     return res;
 }
\ No newline at end of file
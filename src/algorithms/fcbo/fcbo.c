@@ -0,0 +1,320 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "fcbo.h"
+#include "../../bitset/bitset_arena.h"
+#include "../next-closure/next_closure.h"
+#include "../next-closure/preferred.h"
+#include "../next-closure/complete.h"
+
+// The failure of argument j on the current path: NULL, a closure with j
+// added that failed the canonicity test, or conflicting_closure if such a
+// closure was not conflict-free. A failure set F found at an ancestor is
+// contained in the closure of the current set with j added, so the test
+// fails again if F has an argument below j outside the current set.
+static BitSet conflicting_closure;
+
+struct fcbo_child {
+	BitSet* set;
+	SIZE_TYPE generator;
+};
+
+struct fcbo_undo {
+	SIZE_TYPE argument;
+	BitSet* failure;
+};
+
+typedef struct fcbo {
+	AF* attacks;
+	AF* attacked_by;
+	FCbOClosure closure;
+	BitSet* skipped;
+	FCbOVisit visit;
+	void* data;
+	BitSetArena* arena;
+	BitSet** failures;
+	// the canonical closures of a level are searched after all failures of
+	// the level are known, they wait on this stack
+	struct fcbo_child* children;
+	size_t child_count;
+	size_t child_capacity;
+	// the failures replaced on the current path, restored when a level returns
+	struct fcbo_undo* undo;
+	size_t undo_count;
+	size_t undo_capacity;
+	size_t closure_count;
+	bool stop;
+} FCbO;
+
+static void set_failure(FCbO* s, SIZE_TYPE j, BitSet* failure) {
+	if (s->undo_count == s->undo_capacity) {
+		s->undo_capacity = s->undo_capacity ? 2 * s->undo_capacity : 64;
+		s->undo = realloc(s->undo, s->undo_capacity * sizeof(struct fcbo_undo));
+		assert(s->undo != NULL);
+	}
+	s->undo[s->undo_count].argument = j;
+	s->undo[s->undo_count].failure = s->failures[j];
+	++s->undo_count;
+	s->failures[j] = failure;
+}
+
+static void push_child(FCbO* s, BitSet* set, SIZE_TYPE j) {
+	if (s->child_count == s->child_capacity) {
+		s->child_capacity = s->child_capacity ? 2 * s->child_capacity : 64;
+		s->children = realloc(s->children, s->child_capacity * sizeof(struct fcbo_child));
+		assert(s->children != NULL);
+	}
+	s->children[s->child_count].set = set;
+	s->children[s->child_count].generator = j;
+	++s->child_count;
+}
+
+// next is conflict-free, if current is. The arguments that the closure added
+// must not attack next and must not be attacked by current.
+static inline bool is_closure_conflict_free(AF* attacks, AF* attacked_by, BitSet* current, BitSet* next) {
+	SIZE_TYPE k;
+	for (k = bitset_next_set_minus_bit(next, current, 0); k < next->size; k = bitset_next_set_minus_bit(next, current, k + 1))
+		if (CHECK_ARG_ATTACKS_SET(attacks, k, next) || check_set_attacks_arg_by_columns(attacked_by, current, k))
+			return(false);
+	return(true);
+}
+
+static void fcbo_search(FCbO* s, BitSet* current, SIZE_TYPE first) {
+	if ((s->stop = s->visit(current, s->data)))
+		return;
+
+	size_t mark = bitset_arena_mark(s->arena);
+	size_t child_base = s->child_count, undo_base = s->undo_count;
+	BitSet* scratch = bitset_arena_alloc(s->arena);
+	for (SIZE_TYPE j = first; j < s->attacks->size; ++j) {
+		if (TEST_BIT(current, j) || (s->skipped && TEST_BIT(s->skipped, j)))
+			continue;
+		BitSet* failure = s->failures[j];
+		if (failure == &conflicting_closure ||
+			(failure && !bitset_set_minus_is_empty_below(failure, current, j)))
+			continue;
+		if (!can_add_argument(s->attacks, s->attacked_by, current, j)) {
+			// a superset of current is not conflict-free with j either
+			set_failure(s, j, &conflicting_closure);
+			continue;
+		}
+
+		BitSet* next = bitset_arena_alloc(s->arena);
+		SET_BIT(current, j);
+		s->closure(s->attacks, s->attacked_by, current, next, scratch);
+		RESET_BIT(current, j);
+		++s->closure_count;
+
+		if (!bitset_set_minus_is_empty_below(next, current, j))
+			set_failure(s, j, next);
+		else if (!is_closure_conflict_free(s->attacks, s->attacked_by, current, next))
+			set_failure(s, j, &conflicting_closure);
+		else
+			push_child(s, next, j);
+	}
+
+	size_t child_end = s->child_count;
+	for (size_t k = child_base; k < child_end && !s->stop; ++k)
+		fcbo_search(s, s->children[k].set, s->children[k].generator + 1);
+
+	s->child_count = child_base;
+	while (s->undo_count > undo_base) {
+		--s->undo_count;
+		s->failures[s->undo[s->undo_count].argument] = s->undo[s->undo_count].failure;
+	}
+	bitset_arena_release(s->arena, mark);
+}
+
+size_t fcbo_conflict_free_closed_sets(AF* attacks, FCbOClosure closure, BitSet* skipped, FCbOVisit visit, void* data) {
+	FCbO s = {0};
+	s.attacks = attacks;
+	s.attacked_by = get_transpose_framework(attacks);
+	s.closure = closure;
+	s.skipped = skipped;
+	s.visit = visit;
+	s.data = data;
+	s.arena = create_bitset_arena(attacks->size);
+	s.failures = calloc(attacks->size > 0 ? attacks->size : 1, sizeof(BitSet*));
+	assert(s.failures != NULL);
+
+	// the closure of the empty set, no closed set is conflict-free if it is not
+	BitSet* empty = bitset_arena_alloc(s.arena);
+	BitSet* first = bitset_arena_alloc(s.arena);
+	BitSet* scratch = bitset_arena_alloc(s.arena);
+	closure(attacks, s.attacked_by, empty, first, scratch);
+	s.closure_count = 1;
+	if (is_set_conflict_free(attacks, first))
+		fcbo_search(&s, first, 0);
+
+	free(s.failures);
+	free(s.children);
+	free(s.undo);
+	free_bitset_arena(s.arena);
+	release_derived_framework(s.attacked_by);
+	return(s.closure_count);
+}
+
+
+//////////////////// Extensions /////////////////////////
+
+// The closed sets of the stable and preferred extensions
+static void not_attacks_closure(AF* attacks, AF* attacked_by, BitSet* s, BitSet* r, BitSet* scratch) {
+	complement_down_up_arrow_by_columns(attacks, attacked_by, s, scratch, r);
+}
+
+static void semi_complete_closure(AF* attacks, AF* attacked_by, BitSet* s, BitSet* r, BitSet* scratch) {
+	closure_semi_complete(attacks, attacked_by, s, r);
+}
+
+struct fcbo_extensions {
+	AF* attacks;
+	AF* attacked_by;
+	BitSet* up;
+	BitSet* down;
+	// the last admissible set found for the preferred extensions
+	BitSet* candidate;
+	ListNode* extensions;
+	int count;
+};
+
+static bool collect_stable(BitSet* c, void* data) {
+	struct fcbo_extensions* e = data;
+	complement_up_arrow(e->attacks, c, e->up);
+	if (bitset_is_equal(c, e->up)) {
+		BitSet* st_ext = create_bitset(c->size);
+		copy_bitset(c, st_ext);
+		e->extensions = insert_list_node(st_ext, e->extensions);
+		++e->count;
+	}
+	return(false);
+}
+
+static bool find_stable(BitSet* c, void* data) {
+	struct fcbo_extensions* e = data;
+	complement_up_arrow(e->attacks, c, e->up);
+	if (bitset_is_equal(c, e->up)) {
+		copy_bitset(c, e->candidate);
+		++e->count;
+		return(true);
+	}
+	return(false);
+}
+
+// An admissible set that contains the last candidate replaces it, otherwise
+// the candidate is done with and add_candidate keeps the maximal ones.
+static bool collect_admissible(BitSet* c, void* data) {
+	struct fcbo_extensions* e = data;
+	if (!is_conflict_free_set_admissible(c, e->attacks, e->attacked_by, e->up, e->down))
+		return(false);
+	if (e->candidate && bitset_is_subset(e->candidate, c)) {
+		copy_bitset(c, e->candidate);
+		return(false);
+	}
+	if (e->candidate)
+		e->extensions = add_candidate(e->extensions, e->candidate);
+	e->candidate = create_bitset(c->size);
+	copy_bitset(c, e->candidate);
+	return(false);
+}
+
+static bool collect_complete(BitSet* c, void* data) {
+	struct fcbo_extensions* e = data;
+	get_attackers(e->attacked_by, c, e->up);
+	get_victims(e->attacks, c, e->down);
+	if (bitset_is_subset(e->up, e->down)) {
+		BitSet* co_ext = create_bitset(c->size);
+		copy_bitset(c, co_ext);
+		e->extensions = insert_list_node(co_ext, e->extensions);
+		++e->count;
+	}
+	return(false);
+}
+
+static void init_extensions(struct fcbo_extensions* e, AF* af) {
+	e->attacks = af;
+	e->attacked_by = get_transpose_framework(af);
+	e->up = create_bitset(af->size);
+	e->down = create_bitset(af->size);
+	e->candidate = NULL;
+	e->extensions = NULL;
+	e->count = 0;
+}
+
+static void free_extensions(struct fcbo_extensions* e) {
+	free_bitset(e->up);
+	free_bitset(e->down);
+	release_derived_framework(e->attacked_by);
+}
+
+ListNode* ee_st_fcbo(AF* af) {
+	struct fcbo_extensions e;
+	init_extensions(&e, af);
+	size_t closure_count = fcbo_conflict_free_closed_sets(af, not_attacks_closure, NULL, collect_stable, &e);
+	printf("Number of closures computed: %zu\n", closure_count);
+	printf("Number of stable extensions: %d\n", e.count);
+	free_extensions(&e);
+	return(e.extensions);
+}
+
+void se_st_fcbo(AF* af, BitSet* result) {
+	struct fcbo_extensions e;
+	init_extensions(&e, af);
+	e.candidate = result;
+	size_t closure_count = fcbo_conflict_free_closed_sets(af, not_attacks_closure, NULL, find_stable, &e);
+	printf("Number of closures computed: %zu\n", closure_count);
+	free_extensions(&e);
+}
+
+ListNode* ee_pr_fcbo(AF* af) {
+	// the victims of the arguments that are in every admissible set are in none
+	BitSet* mandatory = create_bitset(af->size);
+	BitSet* ignored = create_bitset(af->size);
+	add_ignore(af, mandatory, ignored);
+
+	struct fcbo_extensions e;
+	init_extensions(&e, af);
+	size_t closure_count = fcbo_conflict_free_closed_sets(af, not_attacks_closure, ignored, collect_admissible, &e);
+	if (e.candidate)
+		e.extensions = add_candidate(e.extensions, e.candidate);
+	printf("Number of closures computed: %zu\n", closure_count);
+	free_extensions(&e);
+	free_bitset(mandatory);
+	free_bitset(ignored);
+	return(e.extensions);
+}
+
+ListNode* ee_co_fcbo(AF* af) {
+	// peaceful arguments at the end are in the closure of the other
+	// arguments of a complete extension, see ee_co_next_closure
+	BitSet* peaceful = create_bitset(af->size);
+	for (SIZE_TYPE i = 0; i < af->size; ++i)
+		if (bitset_is_emptyset(af->graph[i]))
+			SET_BIT(peaceful, i);
+	keep_trailing_peaceful_arguments(peaceful);
+
+	struct fcbo_extensions e;
+	init_extensions(&e, af);
+	size_t closure_count = fcbo_conflict_free_closed_sets(af, semi_complete_closure, peaceful, collect_complete, &e);
+	printf("Number of closures computed: %zu\n", closure_count);
+	printf("Number of complete extensions: %d\n", e.count);
+	free_extensions(&e);
+	free_bitset(peaceful);
+	return(e.extensions);
+}
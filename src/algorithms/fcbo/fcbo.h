@@ -0,0 +1,52 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AF_FCBO_H_
+#define AF_FCBO_H_
+
+#include "../../af/af.h"
+#include "../../utils/linked_list.h"
+
+// A closure operator on the arguments of attacks: r is the closure of s.
+// attacked_by is the transpose of attacks, scratch a bitset of the same size.
+typedef void (*FCbOClosure)(AF* attacks, AF* attacked_by, BitSet* s, BitSet* r, BitSet* scratch);
+
+// Called for every conflict-free closed set, closed_set is only valid during
+// the call. Returns true to stop the search.
+typedef bool (*FCbOVisit)(BitSet* closed_set, void* data);
+
+// Enumerate the conflict-free closed sets of closure with Fast Close-by-One
+// (Outrata, Vychodil): a closure that fails the canonicity test is passed
+// down the tree, so that the same argument is not tried again where the test
+// would fail anyway. An argument whose closure is not conflict-free is not
+// tried again below either. Arguments in skipped (may be NULL) are never
+// added to a set, only reached by closures. Returns the number of closures
+// computed.
+size_t fcbo_conflict_free_closed_sets(AF* attacks, FCbOClosure closure, BitSet* skipped, FCbOVisit visit, void* data);
+
+// Computes all stable extensions and returns a linked list of extensions
+ListNode* ee_st_fcbo(AF* af);
+
+// Computes a single stable extension if there are any, and puts it into result
+void se_st_fcbo(AF* af, BitSet* result);
+
+// Computes all preferred extensions
+ListNode* ee_pr_fcbo(AF* af);
+
+// Computes all complete extensions
+ListNode* ee_co_fcbo(AF* af);
+
+#endif /* AF_FCBO_H_ */
@@ -0,0 +1,82 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <assert.h>
+
+#include "grounded_reduct.h"
+#include "connected-components/scc.h"
+
+
+bool returns_extensions(enum prob_type prob, enum alg_type alg)
+{
+	switch (prob) {
+		case EE_ST:
+			return(alg == FCBO || alg == MIS || alg == NEXT_CLOSURE || alg == NORRIS || alg == NORRIS_BU || alg == NOURINE ||
+				   alg == SCC_MIS || alg == WCC_MIS || alg == SCC_NEXT_CLOSURE || alg == SCC_NORRIS || alg == WCC_NORRIS ||
+				   alg == SCC_NORRIS_BU || alg == SCC_NOURINE || alg == WCC_NOURINE);
+		case SE_ST:
+			return(alg == FCBO || alg == MIS || alg == NEXT_CLOSURE || alg == NOURINE);
+		case DC_ST:
+			return(alg == MIS || alg == NEXT_CLOSURE);
+		case EE_PR:
+			return(alg == CBO || alg == FCBO || alg == NEXT_CLOSURE || alg == SCC_CBO || alg == SCC_NEXT_CLOSURE);
+		case EE_CO:
+			return(alg == FCBO || alg == NEXT_CLOSURE);
+		case DC_CO:
+			return(alg == NEXT_CLOSURE || alg == SUBGRAPH || alg == SUBGRAPH_ADJ);
+		case SE_PR:
+		case DC_PR:
+		case DS_PR:
+			return(alg == CBO);
+		case SE_ID:
+			return(alg == NEXT_CLOSURE || alg == SCC_NEXT_CLOSURE);
+		default:
+			return(false);
+	}
+}
+
+
+BitSet* lift_extension(BitSet* extension, PAF* reduct, BitSet* grounded)
+{
+	BitSet* lifted = project_back(extension, reduct);
+	bitset_union(lifted, grounded, lifted);
+	free_bitset(extension);
+	return(lifted);
+}
+
+
+BitSet* lift_witness(BitSet* extension, PAF* reduct, BitSet* grounded, SIZE_TYPE query)
+{
+	BitSet* lifted = lift_extension(extension, reduct, grounded);
+	assert(TEST_BIT(lifted, query));
+	return(lifted);
+}
+
+
+void lift_extensions(ListNode* node, PAF* reduct, BitSet* grounded)
+{
+	restore_base_indices(node, reduct);
+	for (; node; node = node->next)
+		bitset_union(node->c, grounded, node->c);
+}
+
+
+BitSet* grounded_answer(enum prob_type prob, BitSet* grounded, SIZE_TYPE argument)
+{
+	// a counterexample to DS-PR, a witness otherwise
+	bool accepted = TEST_BIT(grounded, argument);
+	return((prob == DS_PR) != accepted ? grounded : NULL);
+}
@@ -0,0 +1,60 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GROUNDED_REDUCT_H
+#define GROUNDED_REDUCT_H
+
+#include <stdbool.h>
+
+#include "../af/af.h"
+#include "../bitset/bitset.h"
+#include "../utils/linked_list.h"
+
+// The algorithms and problems of affca
+enum alg_type {CBO, FCBO, MIS, NEXT_CLOSURE, NORRIS, NORRIS_BU, NOURINE, SCC_CBO, SCC_MIS, WCC_MIS, SCC_NEXT_CLOSURE, SCC_NORRIS, WCC_NORRIS, SCC_NORRIS_BU, SCC_NOURINE, WCC_NOURINE, SUBGRAPH, SUBGRAPH_ADJ, NO_ALGORITHM};
+enum prob_type {EE_ST, SE_ST, CE_ST, DC_ST, EE_PR, SE_PR, DC_PR, DS_PR, SE_ID, EE_CO, DC_CO, DS_CO, SE_GR, DC_GR};
+
+// The grounded extension is in every complete, preferred, stable and ideal
+// extension and the arguments it attacks are in none. The extensions of a
+// framework are those of its reduct, the framework projected to the
+// undecided arguments, with the grounded extension added.
+
+// The solvers that return their extensions or witnesses, instead of printing
+// them. Their frameworks can be reduced by the grounded extension.
+// test_reduct checks the ones listed here.
+bool returns_extensions(enum prob_type prob, enum alg_type alg);
+
+// Map an extension of the reduct back to the framework it was reduced from,
+// the grounded extension is added. extension is freed.
+BitSet* lift_extension(BitSet* extension, PAF* reduct, BitSet* grounded);
+
+// lift_extension for a witness of a credulous query, the lifted set contains
+// query, an argument of the original framework starting from 0.
+BitSet* lift_witness(BitSet* extension, PAF* reduct, BitSet* grounded, SIZE_TYPE query);
+
+// lift_extension for each extension of the list, in place
+void lift_extensions(ListNode* node, PAF* reduct, BitSet* grounded);
+
+// The answer to a DC or DS query on argument, if the grounded extension
+// decides it, without a search. The grounded extension is a complete and
+// admissible witness for its own arguments and contains an attacker of each
+// argument it attacks. Returns grounded as the witness or counterexample to
+// print, NULL if there is none. For DC-ST the grounded extension is only a
+// witness if nothing is undecided, stable extensions have to be searched
+// otherwise.
+BitSet* grounded_answer(enum prob_type prob, BitSet* grounded, SIZE_TYPE argument);
+
+#endif /* GROUNDED_REDUCT_H */
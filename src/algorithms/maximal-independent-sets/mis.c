@@ -1,4 +1,5 @@
 #include "mis.h"
+#include "../../bitset/bitset_arena.h"
 
 
 ListNode* extend(SIZE_TYPE i, 
@@ -7,8 +8,13 @@ ListNode* extend(SIZE_TYPE i,
                  BitSet* dominated, // consists of s and its victims
                  AF* af, 
                  AF* conflicts, 
-                 ListNode* extensions)
+                 ListNode* extensions,
+                 BitSetArena* arena)
 {
+    // s, conflicting and dominated belong to the caller, the bitsets
+    // allocated here are given back to the arena on return
+    size_t mark = bitset_arena_mark(arena);
+
     while (i < af->size && !TEST_BIT(conflicting, i)) {
         if (!TEST_BIT(conflicts->graph[i], i)) {
             SET_BIT(s, i);
@@ -21,74 +27,73 @@ ListNode* extend(SIZE_TYPE i,
 
     if (i == af->size) {
         if (bitset_is_fullset(dominated)) {
-            extensions = insert_list_node(s, extensions);
-        } else {
-            free_bitset(s);
+            BitSet* extension = create_bitset(af->size);
+            copy_bitset(s, extension);
+            extensions = insert_list_node(extension, extensions);
         }
-        free_bitset(conflicting);
-        free_bitset(dominated);
         return extensions;
     }
 
-    BitSet* iset = create_bitset(af->size);
+    BitSet* iset = bitset_arena_alloc(arena);
     bitset_set_minus(s, conflicts->graph[i], iset);
 
     bool canonical = !TEST_BIT(conflicts->graph[i], i);
     if (canonical) {
-        BitSet* canonical_parent = create_bitset(af->size);
+        BitSet* canonical_parent = bitset_arena_alloc(arena);
         copy_bitset(iset, canonical_parent);
         SET_BIT(iset, i);
-        for (SIZE_TYPE j = 0; j < i; ++j) {
-            if(!TEST_BIT(iset, j)) {
-                if (is_bitset_intersection_empty(iset, conflicts->graph[j])) {
-                    // iset is not maximal conflict-free
+        for (SIZE_TYPE j = bitset_next_clear_bit(iset, 0); j < i; j = bitset_next_clear_bit(iset, j + 1)) {
+            // a self-attacking argument is in no conflict-free set
+            if (TEST_BIT(conflicts->graph[j], j))
+                continue;
+            if (is_bitset_intersection_empty(iset, conflicts->graph[j])) {
+                // iset is not maximal conflict-free
+                canonical = false;
+                break;
+            }
+            if (is_bitset_intersection_empty(canonical_parent, conflicts->graph[j])) {
+                if (!TEST_BIT(s, j)) {
+                    // iset can be generated as a child of canonical_parent U {j} or its superset
                     canonical = false;
                     break;
                 }
-                if (is_bitset_intersection_empty(canonical_parent, conflicts->graph[j])) {
-                    if (!TEST_BIT(s, j)) {
-                        // iset can be generated as a child of canonical_parent U {j} or its superset
-                        canonical = false;
-                        break;
-                    }
-                    SET_BIT(canonical_parent, j);
-                }
+                SET_BIT(canonical_parent, j);
             }
         }
-        free_bitset(canonical_parent);
     }
 
-    extensions = extend(i + 1, s, conflicting, dominated, af, conflicts, extensions);
+    extensions = extend(i + 1, s, conflicting, dominated, af, conflicts, extensions, arena);
 
     if (canonical) {
-        BitSet* idominated = create_bitset(af->size);
+        BitSet* idominated = bitset_arena_alloc(arena);
         get_victims(af, iset, idominated);
 
-        BitSet* iconflicting = create_bitset(af->size);
+        BitSet* iconflicting = bitset_arena_alloc(arena);
         get_true_attackers(af, iset, iconflicting);
         bitset_union(iconflicting, idominated, iconflicting);
 
         bitset_union(idominated, iset, idominated);
 
-        extensions = extend(i + 1, iset, iconflicting, idominated, af, conflicts, extensions);
-    } else {
-        free_bitset(iset);
+        extensions = extend(i + 1, iset, iconflicting, idominated, af, conflicts, extensions, arena);
     }
 
+    bitset_arena_release(arena, mark);
     return extensions;
 }
 
 ListNode* ee_st_maximal_independent_sets(AF *af)
 {
-    AF* conflicts = create_conflict_framework(af);
+    AF* conflicts = get_conflict_framework(af);
+    BitSetArena* arena = create_bitset_arena(af->size);
 
-    BitSet* s = create_bitset(af->size);
-    BitSet* conflicting = create_bitset(af->size);
-    BitSet* dominated = create_bitset(af->size);
+    BitSet* s = bitset_arena_alloc(arena);
+    BitSet* conflicting = bitset_arena_alloc(arena);
+    BitSet* dominated = bitset_arena_alloc(arena);
 
-    ListNode* extensions = extend(0, s, conflicting, dominated, af, conflicts, 0);
+    ListNode* extensions = extend(0, s, conflicting, dominated, af, conflicts, 0, arena);
 
-    free_argumentation_framework(conflicts);
+    free_bitset_arena(arena);
+    release_derived_framework(conflicts);
 
     return extensions;
 }
@@ -102,8 +107,12 @@ BitSet* extend_one(SIZE_TYPE i,
                    BitSet* conflicting,
                    BitSet* dominated, // consists of s and its victims
                    AF* af,
-                   AF* conflicts)
+                   AF* conflicts,
+                   BitSetArena* arena)
 {
+    // a returned extension is in the arena, it is copied out by se_st_mis
+    size_t mark = bitset_arena_mark(arena);
+
     while (i < af->size && !TEST_BIT(conflicting, i)) {
         if (!TEST_BIT(conflicts->graph[i], i)) {
             SET_BIT(s, i);
@@ -115,82 +124,84 @@ BitSet* extend_one(SIZE_TYPE i,
     }
 
     if (bitset_is_fullset(dominated)) {
-        free_bitset(conflicting);
-        free_bitset(dominated);
         return s;
     }
 
 
     if (i == af->size) {
-        free_bitset(s);
-        free_bitset(conflicting);
-        free_bitset(dominated);
         return 0;
     }
 
-    BitSet* iset = create_bitset(af->size);
+    BitSet* iset = bitset_arena_alloc(arena);
     bitset_set_minus(s, conflicts->graph[i], iset);
 
     bool canonical = !TEST_BIT(conflicts->graph[i], i);
     if (canonical) {
-        BitSet* canonical_parent = create_bitset(af->size);
+        BitSet* canonical_parent = bitset_arena_alloc(arena);
         copy_bitset(iset, canonical_parent);
         SET_BIT(iset, i);
-        for (SIZE_TYPE j = 0; j < i; ++j) {
-            if(!TEST_BIT(iset, j)) {
-                if (is_bitset_intersection_empty(iset, conflicts->graph[j])) {
-                    // iset is not maximal conflict-free
+        for (SIZE_TYPE j = bitset_next_clear_bit(iset, 0); j < i; j = bitset_next_clear_bit(iset, j + 1)) {
+            // a self-attacking argument is in no conflict-free set
+            if (TEST_BIT(conflicts->graph[j], j))
+                continue;
+            if (is_bitset_intersection_empty(iset, conflicts->graph[j])) {
+                // iset is not maximal conflict-free
+                canonical = false;
+                break;
+            }
+            if (is_bitset_intersection_empty(canonical_parent, conflicts->graph[j])) {
+                if (!TEST_BIT(s, j)) {
+                    // iset can be generated as a child of canonical_parent U {j} or its superset
                     canonical = false;
                     break;
                 }
-                if (is_bitset_intersection_empty(canonical_parent, conflicts->graph[j])) {
-                    if (!TEST_BIT(s, j)) {
-                        // iset can be generated as a child of canonical_parent U {j} or its superset
-                        canonical = false;
-                        break;
-                    }
-                    SET_BIT(canonical_parent, j);
-                }
+                SET_BIT(canonical_parent, j);
             }
         }
-        free_bitset(canonical_parent);
     }
 
-    BitSet* e = extend_one(i + 1, s, conflicting, dominated, af, conflicts);
+    BitSet* e = extend_one(i + 1, s, conflicting, dominated, af, conflicts, arena);
     if(e) {
-        free_bitset(iset);
         return e;
     }
 
     if (canonical) {
-        BitSet* idominated = create_bitset(af->size);
+        BitSet* idominated = bitset_arena_alloc(arena);
         get_victims(af, iset, idominated);
 
-        BitSet* iconflicting = create_bitset(af->size);
+        BitSet* iconflicting = bitset_arena_alloc(arena);
         get_true_attackers(af, iset, iconflicting);
         bitset_union(iconflicting, idominated, iconflicting);
 
         bitset_union(idominated, iset, idominated);
 
-        e = extend_one(i + 1, iset, iconflicting, idominated, af, conflicts);
-    } else {
-        free_bitset(iset);
+        e = extend_one(i + 1, iset, iconflicting, idominated, af, conflicts, arena);
     }
 
+    if (!e) {
+        bitset_arena_release(arena, mark);
+    }
     return e;
 }
 
 BitSet* se_st_mis(AF* af)
 {
-    AF* conflicts = create_conflict_framework(af);
-
-    BitSet* s = create_bitset(af->size);
-    BitSet* conflicting = create_bitset(af->size);
-    BitSet* dominated = create_bitset(af->size);
-
-    BitSet* extension = extend_one(0, s, conflicting, dominated, af, conflicts);
+    AF* conflicts = get_conflict_framework(af);
+    BitSetArena* arena = create_bitset_arena(af->size);
+
+    BitSet* s = bitset_arena_alloc(arena);
+    BitSet* conflicting = bitset_arena_alloc(arena);
+    BitSet* dominated = bitset_arena_alloc(arena);
+
+    BitSet* extension = extend_one(0, s, conflicting, dominated, af, conflicts, arena);
+    if (extension) {
+        s = create_bitset(af->size);
+        copy_bitset(extension, s);
+        extension = s;
+    }
 
-    free_argumentation_framework(conflicts);
+    free_bitset_arena(arena);
+    release_derived_framework(conflicts);
 
     return extension;
 }
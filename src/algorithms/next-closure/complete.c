@@ -23,6 +23,7 @@
 #include "../../utils/linked_list.h"
 #include "../../utils/stack.h"
 #include "../../af/sort.h"
+#include "next_closure.h"
 
 // A complete extension is an admissible extension that contains every argument that it defends.
 // I suggest to use the name semi-complete extension for an extension that contains every argument that it defends.
@@ -30,16 +31,25 @@
 
 BitSet* peaceful_arguments;
 
+// next_conflict_free_semi_complete_intent never adds a peaceful argument.
+// That only loses no extension if the peaceful arguments come after all
+// others: they are then in the closure of the other arguments of an
+// extension. Keep the peaceful arguments after the last non-peaceful one.
+void keep_trailing_peaceful_arguments(BitSet* peaceful) {
+	SIZE_TYPE i = peaceful->size;
+	while (i > 0 && TEST_BIT(peaceful, i - 1))
+		--i;
+	for (SIZE_TYPE j = 0; j < i; ++j)
+		RESET_BIT(peaceful, j);
+}
+
 void closure_semi_complete(AF* attacks, AF* attacked_by, BitSet* s, BitSet* r) {
 	SIZE_TYPE i;
 	copy_bitset(s, r);
 	bool closure_modified;
 
 	BitSet* victims_r = create_bitset(attacks->size);
-	for (i = 0; i < attacks->size; ++i) {
-		if (TEST_BIT(r, i))
-			bitset_union(victims_r, attacks->graph[i], victims_r);
-	}
+	get_victims(attacks, r, victims_r);
 	do {
 		closure_modified = false;
 		for (i = 0; i < attacks->size; i++) {
@@ -53,96 +63,87 @@ void closure_semi_complete(AF* attacks, AF* attacked_by, BitSet* s, BitSet* r) {
 	free_bitset(victims_r);
 }
 
-// Peaceful arguments have to be the rightmost bits of the arguments set
-bool next_conflict_free_semi_complete_intent(AF* attacks, AF* attacked_by, BitSet* current, BitSet* next, BitSet** lectically_smaller_defended) {
+// Peaceful arguments have to be the rightmost bits of the arguments set, they
+// are excluded from prefixes
+bool next_conflict_free_semi_complete_intent(AF* attacks, AF* attacked_by, BitSet* current, BitSet* next, BitSet** lectically_smaller_defended, CompatiblePrefixes* prefixes) {
 	BitSet* tmp = create_bitset(attacks->size);
 	copy_bitset(current, tmp);
 
 	BitSet* tmp_complement = create_bitset(attacks->size);
 	complement_bitset(tmp, tmp_complement);
 
-	// printf("tmp: ");
-	// print_bitset(tmp, stdout);
-	// printf(" ");
-	// print_set(tmp, stdout, "\n");
-	for (int i = attacks->size - 1; i >= 0; --i) {
-		if (TEST_BIT(tmp, i)) {
+	bool found = false;
+	SIZE_TYPE t = update_compatible_prefixes(prefixes, attacks, attacked_by, tmp);
+	SIZE_TYPE i = attacks->size;
+	while (1) {
+		i = previous_compatible_argument(prefixes, t, i);
+		if (i == attacks->size) {
+			// nothing left after the first t elements, drop the last of them
+			if (t == 0)
+				break;
+			--t;
+			i = prefixes->elements[t];
 			RESET_BIT(tmp, i);
-		} else if (!TEST_BIT(peaceful_arguments, i) &&
-				   // adding i to tmp will not make tmp self-defending.
-				   // because tmp is not self-defending and i does not attack any arguments.
-				   // in this case continue with the next i
-			       !CHECK_ARG_ATTACKS_ARG(attacks, i, i) &&
-				   !CHECK_ARG_ATTACKS_SET(attacks, i, tmp) &&
-				   // !TEST_BIT(defends_lectically_smaller_arg, i) &&
-				   is_bitset_intersection_empty(tmp_complement, lectically_smaller_defended[i]) &&
-				   !check_set_attacks_arg(attacks, tmp, i)) {
-
-
-			SET_BIT(tmp, i);
-			closure_semi_complete(attacks, attacked_by, tmp, next);
-
-
-			bool good = true;
-			// is next canonical?
-			for (SIZE_TYPE j = 0; j < i; ++j) {
-				if (TEST_BIT(next, j) && !TEST_BIT(tmp, j)) {
+			continue;
+		}
+		// i would add a lectically smaller argument that tmp does not have
+		if (!is_bitset_intersection_empty(tmp_complement, lectically_smaller_defended[i]))
+			continue;
+
+		SET_BIT(tmp, i);
+		closure_semi_complete(attacks, attacked_by, tmp, next);
+
+		// is next canonical?
+		bool good = bitset_set_minus_is_empty_below(next, tmp, i);
+		if (good) {
+			// is next conflict-free?
+			SIZE_TYPE j;
+			FOR_EACH_SET_BIT_FROM(next, j, i + 1) {
+				if (CHECK_ARG_ATTACKS_SET(attacks, j, next) &&  check_set_attacks_arg_by_columns(attacked_by, tmp, j)) {
 					good = false;
 					break;
 				}
 			}
-			if (good) {
-				// is next conflict-free?
-				for (SIZE_TYPE j = i + 1; j < attacks->size; ++j) {
-					if (TEST_BIT(next, j) && CHECK_ARG_ATTACKS_SET(attacks, j, next) &&  check_set_attacks_arg(attacks, tmp, j)) {
-						good = false;
-						break;
-					}
-				}
-			}
-			if (good) {
-				free_bitset(tmp);
-				free_bitset(tmp_complement);
-				// printf("it is conflict-free\n");
-				return(1);
-			}
-			RESET_BIT(tmp, i);
 		}
+		if (good) {
+			found = true;
+			break;
+		}
+		RESET_BIT(tmp, i);
 	}
 
 	free_bitset(tmp);
 	free_bitset(tmp_complement);
-	return(0);
+	return(found);
 }
 
 // Returns an array of bitsets. The bitset at index i contains the lectically smaller
-// arguments that are defended by i.
+// arguments that are defended by i. They are taken from the defense relation,
+// which is computed as a boolean matrix product.
 BitSet** get_lectically_smaller_defended_arguments(AF* attacks, AF* attacked_by) {
 	int defends_lectically_smaller_count = 0;
 	BitSet** defends_lectically_smaller_args = calloc(sizeof(BitSet*), attacks->size);
 	assert(defends_lectically_smaller_args != NULL);
+	AF* defends = defense_framework(attacks);
 	int i;
 	for (i = 0; i < attacks->size; ++i) {
 		defends_lectically_smaller_args[i] = create_bitset(attacks->size);
-		int j;
-		bool defends = false;
-		for (j = 0; j < attacks->size; ++j) {
-			if (j < i && bitset_is_subset(attacked_by->graph[j], attacks->graph[i])) {
-				// printf("%d defends %d\n", i + 1 , j + 1);
-				SET_BIT(defends_lectically_smaller_args[i], j);
-				defends = true;
-			}
-		}
-		if (defends)
+		// keep the words below i, and the bits below i of the word of i
+		BitSet* r = defends_lectically_smaller_args[i];
+		SIZE_TYPE w = i / BITSET_BASE_SIZE;
+		memcpy(r->elements, defends->graph[i]->elements, w * sizeof(BITSET_BASE_TYPE));
+		r->elements[w] = defends->graph[i]->elements[w] & ((1ULL << (i % BITSET_BASE_SIZE)) - 1);
+		if (!bitset_is_emptyset(r))
 			++defends_lectically_smaller_count;
 	}
+	free_argumentation_framework(defends);
 	printf("Defends lectically smaller count: %d\n", defends_lectically_smaller_count);
 	return(defends_lectically_smaller_args);
 }
 
 
 ListNode* ee_co_next_closure(AF *attacks) {
-	AF* attacked_by = transpose_argumentation_framework(attacks);
+	AF* attacked_by = get_transpose_framework(attacks);
 	// AF* attacked_by_cp = create_argumentation_framework(attacked_by->size);
 
 	BitSet* attackers = create_bitset(attacks->size);
@@ -193,6 +194,9 @@ ListNode* ee_co_next_closure(AF *attacks) {
 	}
 
 
+	keep_trailing_peaceful_arguments(peaceful_arguments);
+	CompatiblePrefixes* prefixes = create_compatible_prefixes(attacks, peaceful_arguments);
+
 	printf("Arguments attacking 0 arguments: %d\n", peaceful_args_count);
 	printf("Arguments attacking 1 argument: %d\n", attacks_one);
 	printf("Arguments attacking more than %d arguments: %d\n", attacks->size / 10, attacks_more_than_half);
@@ -224,7 +228,7 @@ ListNode* ee_co_next_closure(AF *attacks) {
 			copy_bitset(current, co_ext);
 			extensions = insert_list_node(co_ext, extensions);
 		}
-	} while (next_conflict_free_semi_complete_intent(attacks, attacked_by, current, current, lectically_smaller_defended));
+	} while (next_conflict_free_semi_complete_intent(attacks, attacked_by, current, current, lectically_smaller_defended, prefixes));
 
 	printf("Number of concepts generated: %d\n", concept_count);
 	printf("Number of complete extensions: %d\n", complete_extension_count);
@@ -234,8 +238,9 @@ ListNode* ee_co_next_closure(AF *attacks) {
 	free_bitset(attackers);
 	free_bitset(victims);
 	free_bitset(peaceful_arguments);
+	free_compatible_prefixes(prefixes);
 
-	free_argumentation_framework(attacked_by);
+	release_derived_framework(attacked_by);
 	return(extensions);
 }
 
@@ -250,25 +255,18 @@ bool next_conflict_free_semi_complete_intent_2(AF* attacks, AF* attacked_by, Bit
 	for (int i = attacks->size - 1; i >= 0; --i) {
 		if (TEST_BIT(tmp, i)) {
 			RESET_BIT(tmp, i);
-		} else if ( !CHECK_ARG_ATTACKS_ARG(attacks, i, i) &&
-				   !CHECK_ARG_ATTACKS_SET(attacks, i, tmp) &&
-				   !check_set_attacks_arg(attacks, tmp, i)) {
+		} else if (can_add_argument(attacks, attacked_by, tmp, i)) {
 
 			SET_BIT(tmp, i);
 			closure_semi_complete(attacks, attacked_by, tmp, next);
 
-			bool good = true;
 			// is next canonical?
-			for (SIZE_TYPE j = 0; j < i; ++j) {
-				if (TEST_BIT(next, j) && !TEST_BIT(tmp, j)) {
-					good = false;
-					break;
-				}
-			}
+			bool good = bitset_set_minus_is_empty_below(next, tmp, i);
 			if (good) {
 				// is next conflict-free?
-				for (SIZE_TYPE j = i + 1; j < attacks->size; ++j) {
-					if (TEST_BIT(next, j) && CHECK_ARG_ATTACKS_SET(attacks, j, next) &&  check_set_attacks_arg(attacks, tmp, j)) {
+				SIZE_TYPE j;
+				FOR_EACH_SET_BIT_FROM(next, j, i + 1) {
+					if (CHECK_ARG_ATTACKS_SET(attacks, j, next) &&  check_set_attacks_arg_by_columns(attacked_by, tmp, j)) {
 						good = false;
 						break;
 					}
@@ -289,6 +287,51 @@ bool next_conflict_free_semi_complete_intent_2(AF* attacks, AF* attacked_by, Bit
 	return(0);
 }
 
+// Sort attacks in descending order of victim count, move the defenders of
+// argument to the right end and argument to index 0, where the search for a
+// complete extension with it starts. The sorted framework and its transpose
+// are stored in attacks_sorted and attacked_by_sorted. Returns the mapping
+// from their indices to those of attacks. argument must not defend itself.
+int* order_for_dc_co(AF* attacks, int argument, AF** attacks_sorted, AF** attacked_by_sorted) {
+	AF* sorted = create_argumentation_framework(attacks->size);
+	int *mapping = sort_af(attacks, sorted, VICTIM_COUNT, SORT_DESCENDING);
+	AF* sorted_t = transpose_argumentation_framework(sorted);
+
+	// the index of the argument after sorting
+	int argument_index = 0;
+	while (mapping[argument_index] != argument)
+		++argument_index;
+
+	// Move defenders of the argument to the right-end. The argument is not
+	// one of them, but it can be the argument moved from next_index_to_use
+	// to i.
+	int next_index_to_use = sorted->size - 1;
+	int tmp;
+	for (int i = sorted->size - 1; i >= 0; --i) {
+		if (bitset_is_subset(sorted_t->graph[argument_index], sorted->graph[i])) {
+			swap_arguments(sorted, next_index_to_use, i);
+			swap_arguments(sorted_t, next_index_to_use, i);
+			tmp = mapping[next_index_to_use];
+			mapping[next_index_to_use] = mapping[i];
+			mapping[i] = tmp;
+			if (argument_index == next_index_to_use)
+				argument_index = i;
+			--next_index_to_use;
+		}
+	}
+
+	// Now move the argument to the very left bit
+	swap_arguments(sorted, 0, argument_index);
+	swap_arguments(sorted_t, 0, argument_index);
+	tmp = mapping[0];
+	mapping[0] = mapping[argument_index];
+	mapping[argument_index] = tmp;
+
+	*attacks_sorted = sorted;
+	*attacked_by_sorted = sorted_t;
+	return(mapping);
+}
+
 BitSet* dc_co_next_closure_2(AF* attacks, int argument) {
 	BitSet* current = create_bitset(attacks->size);
 	AF* attacked_by = transpose_argumentation_framework(attacks);
@@ -316,61 +359,10 @@ BitSet* dc_co_next_closure_2(AF* attacks, int argument) {
 	// Not self-defending. That is, the argument is not defended.
 	reset_bitset(current);
 
-	// Sort in descending order of victims
-	AF* attacks_sorted = create_argumentation_framework(attacks->size);
-	int *mapping = sort_af(attacks, attacks_sorted, VICTIM_COUNT, SORT_DESCENDING);
-
-	/*
-	printf("attacks:\n");
-	print_argumentation_framework(attacks);
-	printf("attacks_sorted:\n");
-	print_argumentation_framework(attacks_sorted);
-	printf("mapping:\n");
-	for (int i = 0; i < attacks_sorted->size; ++i)
-		printf("%d %d\n", i+1, mapping[i]+1);
-		*/
-
-	// Search the argument in the mapping
-	int argument_index;
-	for (int i = 0; i < attacks_sorted->size; ++i)
-		if (mapping[i] == argument)
-			// The argument is at index i after sorting
-			argument_index = i;
-
-	// Move defenders of the argument to the right-end.
-	AF* attacked_by_sorted = transpose_argumentation_framework(attacks_sorted);
-	int next_index_to_use = attacks_sorted->size - 1;
-	for (int i = attacks_sorted->size - 1; i >= 0; --i) {
-		int tmp;
-		// check if a defender of the (mapped) argument
-		if (bitset_is_subset(attacked_by_sorted->graph[argument_index], attacks_sorted->graph[i])) {
-			// index i of attacks_sorted is a defender of the argument, swap index_to_use and i
-			// do the swap in the frameworks
-			swap_arguments(attacks_sorted, next_index_to_use, i);
-			swap_arguments(attacked_by_sorted, next_index_to_use, i);
-			// do the swap in the mapping
-			tmp = mapping[next_index_to_use];
-			mapping[next_index_to_use] = mapping[i];
-			mapping[i] = tmp;
-
-			// We do not need to check if the argument itself is also moved. This cannot be the case
-			// since otherwise the set current would be self-defending.
-			--next_index_to_use;
-		}
-	}
-
-	/*
-	printf("mapping:\n");
-	for (int i = 0; i < attacks_sorted->size; ++i)
-		printf("%d %d\n", i+1, mapping[i]+1);
-		*/
-
-	// Now move the argument to the very left bit ...
-	swap_arguments(attacks_sorted, 0, argument_index);
-	swap_arguments(attacked_by_sorted, 0, argument_index);
-	int tmp = mapping[0];
-	mapping[0] = mapping[argument_index];
-	mapping[argument_index] = tmp;
+	// Sort in descending order of victims, the defenders of the argument
+	// last and the argument first
+	AF *attacks_sorted, *attacked_by_sorted;
+	int *mapping = order_for_dc_co(attacks, argument, &attacks_sorted, &attacked_by_sorted);
 	// and set the very left bit
 	SET_BIT(current, 0);
 
@@ -443,10 +435,11 @@ BitSet* dc_co_subgraph_next_closure(AF* af, int argument) {
 	// print_set(extension,stdout,"\n");
 	// close the computed extension in the whole framework
 	BitSet* back_projected_extension = project_back(extension, projection);
-	AF *attacked_by = transpose_argumentation_framework(af);
+	AF *attacked_by = get_transpose_framework(af);
 	BitSet *closure = create_bitset(af->size);
 	// closure_semi_complete(af, attacked_by, back_projected_extension, extension);
 	closure_semi_complete(af, attacked_by, back_projected_extension, closure);
+	release_derived_framework(attacked_by);
 	return(closure);
 }
 
@@ -474,6 +467,8 @@ BitSet* dc_co_next_closure(AF* af, int argument) {
 	// }
 	// printf("1 <-> %d\n", argument + 1);
 
+	// the lists and derived frameworks describe the framework before the swap
+	drop_derived_data(af);
 	BitSet* tmp = create_bitset(af->size);
 	copy_bitset(af->graph[0], tmp);
 	copy_bitset(af->graph[argument], af->graph[0]);
@@ -506,6 +501,8 @@ BitSet* dc_co_next_closure(AF* af, int argument) {
 			SET_BIT(peaceful_arguments, i);
 		}
 	}
+	keep_trailing_peaceful_arguments(peaceful_arguments);
+	CompatiblePrefixes* prefixes = create_compatible_prefixes(af, peaceful_arguments);
 
 	BitSet* attackers = create_bitset(af->size);
 	BitSet* victims = create_bitset(af->size);
@@ -545,10 +542,11 @@ BitSet* dc_co_next_closure(AF* af, int argument) {
 			free_bitset(attackers);
 			free_bitset(victims);
 			free_bitset(peaceful_arguments);
+			free_compatible_prefixes(prefixes);
 			free_argumentation_framework(attacked_by);
 			return(current);
 		}
-	} while (next_conflict_free_semi_complete_intent(af, attacked_by, current, current, lectically_smaller_defended));
+	} while (next_conflict_free_semi_complete_intent(af, attacked_by, current, current, lectically_smaller_defended, prefixes));
 
 	printf("Number of concepts generated: %d\n", concept_count);
 
@@ -556,6 +554,7 @@ BitSet* dc_co_next_closure(AF* af, int argument) {
 	free_bitset(attackers);
 	free_bitset(victims);
 	free_bitset(peaceful_arguments);
+	free_compatible_prefixes(prefixes);
 	free_argumentation_framework(attacked_by);
 
 	reset_bitset(current);
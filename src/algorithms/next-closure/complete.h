@@ -23,9 +23,19 @@
 // Computes all complete extensions and puts them into result
 ListNode* ee_co_next_closure(AF* af);
 
+// r is the smallest superset of s that contains every argument it defends
+void closure_semi_complete(AF* attacks, AF* attacked_by, BitSet* s, BitSet* r);
+
+// Keep only the peaceful arguments after the last non-peaceful one
+void keep_trailing_peaceful_arguments(BitSet* peaceful);
+
 // Assuming arguments are sorted in descending order of victim count: -s 1 -d 1
 BitSet* dc_co_next_closure(AF* attacks, int argument);
 
+// Order the arguments for dc_co_next_closure_2, the mapping gives the
+// index in attacks of each index in the ordered frameworks
+int* order_for_dc_co(AF* attacks, int argument, AF** attacks_sorted, AF** attacked_by_sorted);
+
 BitSet* dc_co_next_closure_2(AF* attacks, int argument);
 
 BitSet* dc_co_subgraph_next_closure(AF* attacks, int argument);
@@ -14,48 +14,64 @@
  * limitations under the License.
  */
 
+#include <stdlib.h>
+#include <assert.h>
+
 #include "../../bitset/bitset.h"
 #include "../../af/af.h"
+#include "next_closure.h"
 
-BitSet* next_conflict_free_intent(AF* not_attacks, AF* attacks, BitSet* previous) {
-	BitSet* current = create_bitset(attacks->size);
-	copy_bitset(previous, current);
-	BitSet* next = create_bitset(attacks->size);
-
-	for (int i = attacks->size - 1; i >= 0; --i) {
-		if (TEST_BIT(current, i)) {
-			RESET_BIT(current, i);
-		} else if (!CHECK_ARG_ATTACKS_ARG(attacks, i, i) &&
-				   !CHECK_ARG_ATTACKS_SET(attacks, i, current) &&
-				   !check_set_attacks_arg(attacks, current, i)) {
-			SET_BIT(current, i);
-			down_up_arrow(not_attacks, current, next);
-
-			bool good = true;
-			// is next canonical?
-			for (SIZE_TYPE j = 0; j < i; ++j) {
-				if (TEST_BIT(next, j) && !TEST_BIT(current, j)) {
-					good = false;
-					break;
-				}
-			}
-			if (good) {
-				// is next conflict-free?
-				for (SIZE_TYPE j = i + 1; j < attacks->size; ++j) {
-					if (TEST_BIT(next, j) && CHECK_ARG_ATTACKS_SET(attacks, j, next)) {
-						// we don't check if current attacks j, since this is impossible
-						good = false;
-						break;
-					}
-				}
-			}
-			if (good) {
-				return next;
-			}
-			RESET_BIT(current, i);
-		}
-	}
+extern inline SIZE_TYPE previous_compatible_argument(CompatiblePrefixes* prefixes, SIZE_TYPE t, SIZE_TYPE i);
+
+CompatiblePrefixes* create_compatible_prefixes(AF* attacks, BitSet* excluded) {
+	CompatiblePrefixes* prefixes = malloc(sizeof(CompatiblePrefixes));
+	assert(prefixes != NULL);
+	prefixes->size = attacks->size;
+	// a conflict-free set has at most size elements, the levels are created on first use
+	prefixes->levels = calloc(attacks->size + 1, sizeof(BitSet*));
+	prefixes->elements = malloc((attacks->size > 0 ? attacks->size : 1) * sizeof(SIZE_TYPE));
+	assert(prefixes->levels != NULL && prefixes->elements != NULL);
+	prefixes->set = create_bitset(attacks->size);
+	prefixes->depth = 0;
+
+	prefixes->levels[0] = create_bitset(attacks->size);
+	set_bitset(prefixes->levels[0]);
+	for (SIZE_TYPE i = 0; i < attacks->size; ++i)
+		if (CHECK_ARG_ATTACKS_ARG(attacks, i, i))
+			RESET_BIT(prefixes->levels[0], i);
+	if (excluded)
+		bitset_set_minus(prefixes->levels[0], excluded, prefixes->levels[0]);
+	return(prefixes);
+}
 
-	free_bitset(next);
-	return 0;
+void free_compatible_prefixes(CompatiblePrefixes* prefixes) {
+	for (SIZE_TYPE t = 0; t <= prefixes->size; ++t)
+		if (prefixes->levels[t])
+			free_bitset(prefixes->levels[t]);
+	free(prefixes->levels);
+	free(prefixes->elements);
+	free_bitset(prefixes->set);
+	free(prefixes);
+}
+
+SIZE_TYPE update_compatible_prefixes(CompatiblePrefixes* prefixes, AF* attacks, AF* attacked_by, BitSet* s) {
+	// the levels are kept up to the first argument in which s and the set of
+	// the levels differ, the elements below it are counted a word at a time
+	SIZE_TYPE first;
+	SIZE_TYPE t = cut_compatible_prefix(s->elements, prefixes->set->elements, s->base_count, &first);
+	if (first == s->base_count * BITSET_BASE_SIZE)
+		return(t);
+
+	SIZE_TYPE i;
+	FOR_EACH_SET_BIT_FROM(s, i, first) {
+		prefixes->elements[t] = i;
+		SET_BIT(prefixes->set, i);
+		if (!prefixes->levels[t + 1])
+			prefixes->levels[t + 1] = create_bitset(prefixes->size);
+		next_compatible_level(prefixes->levels[t]->elements, attacks->graph[i]->elements,
+				attacked_by->graph[i]->elements, s->base_count, prefixes->levels[t + 1]->elements);
+		++t;
+	}
+	prefixes->depth = t;
+	return(t);
 }
@@ -17,4 +17,87 @@
 #ifndef NEXT_CLOSURE_H
 #define NEXT_CLOSURE_H
 
+#include "../../af/af.h"
+
+// The successor loops of Next-Closure try the arguments i below the last
+// element of a conflict-free set, from the largest one down, with the set cut
+// to its elements below i. The arguments that can be added to the first t
+// elements without a conflict are kept for every t. Consecutive sets share
+// their first elements, so the levels are kept from one set to the next and
+// only the levels of the new elements are computed.
+typedef struct compatible_prefixes {
+	SIZE_TYPE size;
+	// levels[t]: the arguments that are not excluded, not self-attacking and
+	// in no conflict with elements[0] ... elements[t - 1]
+	BitSet** levels;
+	// the elements of the set the levels were computed for, in increasing
+	// order, and the set itself
+	SIZE_TYPE* elements;
+	BitSet* set;
+	// number of elements of set
+	SIZE_TYPE depth;
+} CompatiblePrefixes;
+
+// The steps of update_compatible_prefixes on the words of the sets, shared
+// with the solvers of next_closure_fixed_width.c, where base_count is a
+// constant and the loops are unrolled.
+
+// Cut set to its elements below the first argument in which s and set
+// differ, put that argument in first and return the number of elements kept.
+// first is base_count * BITSET_BASE_SIZE if s and set are equal.
+static inline SIZE_TYPE cut_compatible_prefix(const BITSET_BASE_TYPE* s, BITSET_BASE_TYPE* set, SIZE_TYPE base_count, SIZE_TYPE* first) {
+	SIZE_TYPE k = 0, t = 0;
+	while (k < base_count && s[k] == set[k])
+		t += __builtin_popcountll(s[k++]);
+	if (k == base_count) {
+		*first = base_count * BITSET_BASE_SIZE;
+		return(t);
+	}
+
+	BITSET_BASE_TYPE diff = s[k] ^ set[k];
+	BITSET_BASE_TYPE below = (diff & -diff) - 1;
+	t += __builtin_popcountll(s[k] & below);
+	set[k] &= below;
+	for (SIZE_TYPE l = k + 1; l < base_count; ++l)
+		set[l] = 0;
+	*first = k * BITSET_BASE_SIZE + __builtin_ctzll(diff);
+	return(t);
+}
+
+// The level after adding an argument with the given victims and attackers:
+// the arguments of level in no conflict with it, see can_add_argument
+static inline void next_compatible_level(const BITSET_BASE_TYPE* level, const BITSET_BASE_TYPE* victims, const BITSET_BASE_TYPE* attackers, SIZE_TYPE base_count, BITSET_BASE_TYPE* next_level) {
+	_Pragma("GCC unroll 8")
+	for (SIZE_TYPE l = 0; l < base_count; ++l)
+		next_level[l] = level[l] & ~(victims[l] | attackers[l]);
+}
+
+// excluded (may be NULL): arguments that are never added
+CompatiblePrefixes* create_compatible_prefixes(AF* attacks, BitSet* excluded);
+
+void free_compatible_prefixes(CompatiblePrefixes* prefixes);
+
+// Compute the levels of the conflict-free set s, return its number of elements
+SIZE_TYPE update_compatible_prefixes(CompatiblePrefixes* prefixes, AF* attacks, AF* attacked_by, BitSet* s);
+
+// The largest argument below i that can be added to the first t elements and
+// comes after them, prefixes->size if there is none
+inline SIZE_TYPE previous_compatible_argument(CompatiblePrefixes* prefixes, SIZE_TYPE t, SIZE_TYPE i) {
+	if (i == 0)
+		return(prefixes->size);
+	SIZE_TYPE j = bitset_prev_set_bit(prefixes->levels[t], i - 1);
+	if (j == prefixes->size || (t > 0 && j <= prefixes->elements[t - 1]))
+		return(prefixes->size);
+	return(j);
+}
+
+// j can be added to the conflict-free set current without a conflict. This is
+// the filter of the levels above for a single argument, for the searches that
+// do not keep them.
+static inline bool can_add_argument(AF* attacks, AF* attacked_by, BitSet* current, SIZE_TYPE j) {
+	return(!CHECK_ARG_ATTACKS_ARG(attacks, j, j) &&
+		   !CHECK_ARG_ATTACKS_SET(attacks, j, current) &&
+		   !check_set_attacks_arg_by_columns(attacked_by, current, j));
+}
+
 #endif //NEXT_CLOSURE_H
@@ -0,0 +1,276 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "next_closure.h"
+#include "next_closure_fixed_width.h"
+#include "preferred.h"
+
+// CompatiblePrefixes##W mirrors CompatiblePrefixes of next_closure.h, with
+// FIXED_WIDTH_CAPACITY(W) in place of size as the result of
+// previous_compatible##W if there is no argument. The levels are updated by
+// the steps of update_compatible_prefixes.
+// The framework and the prefixes of a solver call are allocated once, as a
+// NextClosure##W, about 100 KB for W = 8. Only the sets are kept on the stack.
+
+#define DEFINE_FIXED_WIDTH_NEXT_CLOSURE(W)											\
+																					\
+typedef struct {																	\
+	BitSet##W levels[FIXED_WIDTH_CAPACITY(W) + 1];									\
+	SIZE_TYPE elements[FIXED_WIDTH_CAPACITY(W)];									\
+	BitSet##W set;																	\
+} CompatiblePrefixes##W;															\
+																					\
+typedef struct {																	\
+	AF##W af;																		\
+	CompatiblePrefixes##W prefixes;													\
+} NextClosure##W;																	\
+																					\
+/* create_compatible_prefixes for attacks loaded */									\
+static NextClosure##W* create_next_closure##W(AF* attacks) {						\
+	NextClosure##W* nc = malloc(sizeof(NextClosure##W));							\
+	assert(nc != NULL);																\
+	load_af##W(attacks, &nc->af);													\
+	nc->prefixes.levels[0] = nc->af.all;											\
+	for (SIZE_TYPE i = 0; i < attacks->size; ++i)									\
+		if (FIXED_WIDTH_TEST_BIT(nc->af.graph[i], i))								\
+			FIXED_WIDTH_RESET_BIT(nc->prefixes.levels[0], i);						\
+	nc->prefixes.set = bitset##W##_empty();											\
+	return(nc);																		\
+}																					\
+																					\
+static SIZE_TYPE update_compatible_prefixes##W(CompatiblePrefixes##W* prefixes,	\
+		AF##W* af, BitSet##W s) {													\
+	SIZE_TYPE first;																\
+	SIZE_TYPE t = cut_compatible_prefix(s.words, prefixes->set.words, W, &first);	\
+	if (first == FIXED_WIDTH_CAPACITY(W))											\
+		return(t);																	\
+																					\
+	SIZE_TYPE i;																	\
+	for (i = bitset##W##_next(s, first); i < FIXED_WIDTH_CAPACITY(W);				\
+			i = bitset##W##_next(s, i + 1)) {										\
+		prefixes->elements[t] = i;													\
+		FIXED_WIDTH_SET_BIT(prefixes->set, i);										\
+		next_compatible_level(prefixes->levels[t].words, af->graph[i].words,		\
+				af->attacked_by[i].words, W, prefixes->levels[t + 1].words);		\
+		++t;																		\
+	}																				\
+	return(t);																		\
+}																					\
+																					\
+static inline SIZE_TYPE previous_compatible##W(CompatiblePrefixes##W* prefixes,	\
+		SIZE_TYPE t, SIZE_TYPE i) {													\
+	if (i == 0)																		\
+		return(FIXED_WIDTH_CAPACITY(W));											\
+	SIZE_TYPE j = bitset##W##_prev(prefixes->levels[t], i - 1);						\
+	if (j == FIXED_WIDTH_CAPACITY(W) || (t > 0 && j <= prefixes->elements[t - 1]))	\
+		return(FIXED_WIDTH_CAPACITY(W));											\
+	return(j);																		\
+}																					\
+																					\
+/* next_conflict_free_closure of stable.c, current is changed */					\
+static bool next_conflict_free_closure##W(AF##W* af,								\
+		CompatiblePrefixes##W* prefixes, BitSet##W current, BitSet##W* next) {		\
+	SIZE_TYPE t = update_compatible_prefixes##W(prefixes, af, current);				\
+	SIZE_TYPE i = FIXED_WIDTH_CAPACITY(W);											\
+	while (1) {																		\
+		i = previous_compatible##W(prefixes, t, i);									\
+		if (i == FIXED_WIDTH_CAPACITY(W)) {											\
+			if (t == 0)																\
+				return(false);														\
+			--t;																	\
+			i = prefixes->elements[t];												\
+			FIXED_WIDTH_RESET_BIT(current, i);										\
+			continue;																\
+		}																			\
+																					\
+		FIXED_WIDTH_SET_BIT(current, i);											\
+		*next = complement_down_up_arrow##W(af, current);							\
+		FIXED_WIDTH_RESET_BIT(current, i);											\
+		if (bitset##W##_set_minus_is_empty_below(*next, current, i))				\
+			return(true);															\
+	}																				\
+}																					\
+																					\
+/* next_conflict_free_intent of preferred.c */										\
+static bool next_conflict_free_intent##W(AF##W* af,								\
+		CompatiblePrefixes##W* prefixes, BitSet##W current, BitSet##W* next) {		\
+	SIZE_TYPE t = update_compatible_prefixes##W(prefixes, af, current);				\
+	SIZE_TYPE i = FIXED_WIDTH_CAPACITY(W);											\
+	while (1) {																		\
+		i = previous_compatible##W(prefixes, t, i);									\
+		if (i == FIXED_WIDTH_CAPACITY(W)) {											\
+			if (t == 0)																\
+				return(false);														\
+			--t;																	\
+			i = prefixes->elements[t];												\
+			FIXED_WIDTH_RESET_BIT(current, i);										\
+			continue;																\
+		}																			\
+																					\
+		FIXED_WIDTH_SET_BIT(current, i);											\
+		*next = complement_down_up_arrow##W(af, current);							\
+		bool good = bitset##W##_set_minus_is_empty_below(*next, current, i);		\
+		SIZE_TYPE j;																\
+		for (j = bitset##W##_next(*next, i + 1); good &&							\
+				j < FIXED_WIDTH_CAPACITY(W); j = bitset##W##_next(*next, j + 1))	\
+			good = !bitset##W##_intersects(af->graph[j], *next);					\
+		if (good)																	\
+			return(true);															\
+		FIXED_WIDTH_RESET_BIT(current, i);											\
+	}																				\
+}																					\
+																					\
+static inline bool is_admissible##W(AF##W* af, BitSet##W s) {						\
+	return(bitset##W##_is_subset(complement_up_arrow##W(af, s),					\
+				complement_down_arrow##W(af, s)));									\
+}																					\
+																					\
+/* add_ignore of preferred.c */														\
+static void add_ignore##W(AF##W* af, BitSet##W* mandatory, BitSet##W* ignored) {	\
+	SIZE_TYPE mandatory_size = 0, ignored_size = 0, new_size = 0;					\
+	*ignored = bitset##W##_empty();													\
+	do {																			\
+		ignored_size = new_size;													\
+		*mandatory = af->all;														\
+		for (SIZE_TYPE i = 0; i < af->size; ++i) {									\
+			if (FIXED_WIDTH_TEST_BIT(*ignored, i))									\
+				continue;															\
+			*mandatory = bitset##W##_set_minus(*mandatory, af->graph[i]);			\
+			if (bitset##W##_is_empty(*mandatory))									\
+				break;																\
+		}																			\
+		new_size = bitset##W##_count(*mandatory);									\
+		if (new_size == mandatory_size)												\
+			break;																	\
+		mandatory_size = new_size;													\
+																					\
+		SIZE_TYPE i;																\
+		FOR_EACH_FIXED_WIDTH_BIT(W, *mandatory, i)									\
+			*ignored = bitset##W##_union(*ignored, af->graph[i]);					\
+		new_size = bitset##W##_count(*ignored);										\
+	} while (new_size != ignored_size);												\
+}																					\
+																					\
+static ListNode* ee_st_next_closure_##W(AF* attacks) {								\
+	NextClosure##W* nc = create_next_closure##W(attacks);							\
+																					\
+	BitSet##W current = bitset##W##_empty(), c;										\
+	int concept_count = 0, stable_extension_count = 0;								\
+	ListNode* result_list = NULL;													\
+	while (next_conflict_free_closure##W(&nc->af, &nc->prefixes, current, &c)) {	\
+		++concept_count;															\
+		if (bitset##W##_is_equal(c, complement_up_arrow##W(&nc->af, c))) {			\
+			BitSet* st_ext = create_bitset(attacks->size);							\
+			bitset##W##_store(c, st_ext);											\
+			++stable_extension_count;												\
+			result_list = insert_list_node(st_ext, result_list);					\
+		}																			\
+		current = c;																\
+	}																				\
+	free(nc);																		\
+	printf("Number of concepts generated: %d\n", concept_count);					\
+	printf("Number of stable extensions: %d\n", stable_extension_count);			\
+	return(result_list);															\
+}																					\
+																					\
+static void se_st_next_closure_##W(AF* attacks, BitSet* result) {					\
+	NextClosure##W* nc = create_next_closure##W(attacks);							\
+																					\
+	BitSet##W current = bitset##W##_empty(), c;										\
+	int concept_count = 0;															\
+	while (next_conflict_free_closure##W(&nc->af, &nc->prefixes, current, &c)) {	\
+		++concept_count;															\
+		if (bitset##W##_is_equal(c, complement_up_arrow##W(&nc->af, c))) {			\
+			bitset##W##_store(c, result);											\
+			break;																	\
+		}																			\
+		current = c;																\
+	}																				\
+	free(nc);																		\
+	printf("Number of concepts generated: %d\n", concept_count);					\
+}																					\
+																					\
+static ListNode* ee_pr_next_closure_##W(AF* attacks) {								\
+	NextClosure##W* nc = create_next_closure##W(attacks);							\
+	BitSet##W c, ignored;															\
+	add_ignore##W(&nc->af, &c, &ignored);											\
+	nc->prefixes.levels[0] = bitset##W##_set_minus(nc->prefixes.levels[0], ignored);	\
+																					\
+	ListNode* first_candidate = NULL;												\
+	/* c is the last admissible set of the current branch if has_c */				\
+	bool has_c = true;																\
+	BitSet##W previous = c, intent;													\
+	while (next_conflict_free_intent##W(&nc->af, &nc->prefixes, previous, &intent)) {	\
+		if (!has_c || bitset##W##_is_subset(c, intent)) {							\
+			if (is_admissible##W(&nc->af, intent)) {								\
+				c = intent;															\
+				has_c = true;														\
+			}																		\
+		} else {																	\
+			BitSet* candidate = create_bitset(attacks->size);						\
+			bitset##W##_store(c, candidate);										\
+			first_candidate = add_candidate(first_candidate, candidate);			\
+			has_c = is_admissible##W(&nc->af, intent);								\
+			c = intent;																\
+		}																			\
+		previous = intent;															\
+	}																				\
+	if (has_c) {																	\
+		BitSet* candidate = create_bitset(attacks->size);							\
+		bitset##W##_store(c, candidate);											\
+		first_candidate = add_candidate(first_candidate, candidate);				\
+	}																				\
+	free(nc);																		\
+	return(first_candidate);														\
+}
+
+DEFINE_FIXED_WIDTH_NEXT_CLOSURE(1)
+DEFINE_FIXED_WIDTH_NEXT_CLOSURE(2)
+DEFINE_FIXED_WIDTH_NEXT_CLOSURE(4)
+DEFINE_FIXED_WIDTH_NEXT_CLOSURE(8)
+
+ListNode* ee_st_next_closure_fixed_width(AF* af) {
+	switch (af_fixed_width(af)) {
+	case 1: return(ee_st_next_closure_1(af));
+	case 2: return(ee_st_next_closure_2(af));
+	case 4: return(ee_st_next_closure_4(af));
+	case 8: return(ee_st_next_closure_8(af));
+	}
+	return(NULL);
+}
+
+void se_st_next_closure_fixed_width(AF* af, BitSet* result) {
+	switch (af_fixed_width(af)) {
+	case 1: se_st_next_closure_1(af, result); break;
+	case 2: se_st_next_closure_2(af, result); break;
+	case 4: se_st_next_closure_4(af, result); break;
+	case 8: se_st_next_closure_8(af, result); break;
+	}
+}
+
+ListNode* ee_pr_next_closure_fixed_width(AF* af) {
+	switch (af_fixed_width(af)) {
+	case 1: return(ee_pr_next_closure_1(af));
+	case 2: return(ee_pr_next_closure_2(af));
+	case 4: return(ee_pr_next_closure_4(af));
+	case 8: return(ee_pr_next_closure_8(af));
+	}
+	return(NULL);
+}
@@ -0,0 +1,35 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NEXT_CLOSURE_FIXED_WIDTH_H
+#define NEXT_CLOSURE_FIXED_WIDTH_H
+
+#include "../../af/af_fixed_width.h"
+#include "../../utils/linked_list.h"
+
+// The Next-Closure solvers of stable.c and preferred.c built once per width
+// (see af_fixed_width.h), EE-ST, SE-ST and EE-PR only. The framework and the
+// compatible prefixes are allocated once per call, the sets are kept on the
+// stack. The generic solvers call these for the frameworks with
+// af_fixed_width(af) > 0, they print and return the same.
+
+ListNode* ee_st_next_closure_fixed_width(AF* af);
+
+void se_st_next_closure_fixed_width(AF* af, BitSet* result);
+
+ListNode* ee_pr_next_closure_fixed_width(AF* af);
+
+#endif //NEXT_CLOSURE_FIXED_WIDTH_H
@@ -16,51 +16,59 @@
 
 #include "preferred.h"
 #include "../../utils/linked_list.h"
+#include "next_closure.h"
+#include "next_closure_fixed_width.h"
 
 
-BitSet* next_conflict_free_intent(AF* not_attacks, AF* attacks, BitSet* previous, BitSet* ignored) {
+// attacked_by is the transpose of attacks, the arguments are taken from the
+// compatible prefixes of previous
+BitSet* next_conflict_free_intent(AF* attacks, AF* attacked_by, BitSet* previous, CompatiblePrefixes* prefixes) {
 	BitSet* current = create_bitset(attacks->size);
 	copy_bitset(previous, current);
 	BitSet* next = create_bitset(attacks->size);
-
-	for (int i = attacks->size - 1; i >= 0; --i) {
-		if (TEST_BIT(current, i)) {
+	BitSet* down = create_bitset(attacks->size);
+
+	SIZE_TYPE t = update_compatible_prefixes(prefixes, attacks, attacked_by, current);
+	SIZE_TYPE i = attacks->size;
+	while (1) {
+		i = previous_compatible_argument(prefixes, t, i);
+		if (i == attacks->size) {
+			// nothing left after the first t elements, drop the last of them
+			if (t == 0)
+				break;
+			--t;
+			i = prefixes->elements[t];
 			RESET_BIT(current, i);
-		} else if (!TEST_BIT(ignored, i) &&
-				   !CHECK_ARG_ATTACKS_ARG(attacks, i, i) &&
-				   !CHECK_ARG_ATTACKS_SET(attacks, i, current) &&
-				   !check_set_attacks_arg(attacks, current, i)) {
-			SET_BIT(current, i);
-			down_up_arrow(not_attacks, current, next);
+			continue;
+		}
 
-			bool good = true;
-			// is next canonical?
-			for (SIZE_TYPE j = 0; j < i; ++j) {
-				if (TEST_BIT(next, j) && !TEST_BIT(current, j)) {
+		SET_BIT(current, i);
+		complement_down_up_arrow_by_columns(attacks, attacked_by, current, down, next);
+
+		// is next canonical?
+		bool good = bitset_set_minus_is_empty_below(next, current, i);
+		if (good) {
+			// is next conflict-free?
+			SIZE_TYPE j;
+			FOR_EACH_SET_BIT_FROM(next, j, i + 1) {
+				if (CHECK_ARG_ATTACKS_SET(attacks, j, next)) {
+					// we don't check if current attacks j, since this is impossible
 					good = false;
 					break;
 				}
 			}
-			if (good) {
-				// is next conflict-free?
-				for (SIZE_TYPE j = i + 1; j < attacks->size; ++j) {
-					if (TEST_BIT(next, j) && CHECK_ARG_ATTACKS_SET(attacks, j, next)) {
-						// we don't check if current attacks j, since this is impossible
-						good = false;
-						break;
-					}
-				}
-			}
-			if (good) {
-				free_bitset(current);
-				return next;
-			}
-			RESET_BIT(current, i);
 		}
+		if (good) {
+			free_bitset(current);
+			free_bitset(down);
+			return next;
+		}
+		RESET_BIT(current, i);
 	}
 
 	free_bitset(current);
 	free_bitset(next);
+	free_bitset(down);
 	return 0;
 }
 
@@ -96,15 +104,15 @@ ListNode* add_candidate(ListNode* head, BitSet* c)
 }
 
 
-bool is_conflict_free_set_admissible(BitSet* s, AF* not_attacks, BitSet* up, BitSet* down)
+bool is_conflict_free_set_admissible(BitSet* s, AF* attacks, AF* attacked_by, BitSet* up, BitSet* down)
 {
-	up_arrow(not_attacks, s, up);
-    down_arrow(not_attacks, s, down);
+	complement_up_arrow(attacks, s, up);
+    complement_down_arrow_by_columns(attacked_by, s, down);
     return bitset_is_subset(up, down);
 }
 
 
-void add_ignore(AF* af, AF* not_attacks, BitSet* mandatory, BitSet* ignored)
+void add_ignore(AF* af, BitSet* mandatory, BitSet* ignored)
 {
 	// mandatory and ignored are assumed to be empty here
 	SIZE_TYPE mandatory_size = 0;
@@ -115,9 +123,10 @@ void add_ignore(AF* af, AF* not_attacks, BitSet* mandatory, BitSet* ignored)
 		ignored_size = new_size;
 
 		set_bitset(mandatory);
-		for (SIZE_TYPE i = 0; i < af->size && !bitset_is_emptyset(mandatory); ++i) {
-			if (!TEST_BIT(ignored, i)) {
-				bitset_intersection(mandatory, not_attacks->graph[i], mandatory);
+		for (SIZE_TYPE i = 0; i < af->size; ++i) {
+			if (!TEST_BIT(ignored, i) &&
+				bitset_set_minus_is_empty(mandatory, af->graph[i], mandatory)) {
+				break;
 			}
 		}
 		new_size = count_bits(mandatory);
@@ -126,10 +135,9 @@ void add_ignore(AF* af, AF* not_attacks, BitSet* mandatory, BitSet* ignored)
 		}
 		mandatory_size = new_size;
 
-		for (SIZE_TYPE i = 0; i < af->size; ++i) {
-			if (TEST_BIT(mandatory, i)) {
-				bitset_union(ignored, af->graph[i], ignored);
-			}
+		SIZE_TYPE i;
+		FOR_EACH_SET_BIT(mandatory, i) {
+			bitset_union(ignored, af->graph[i], ignored);
 		}
 		new_size = count_bits(ignored);
 	} while (new_size != ignored_size);
@@ -138,25 +146,29 @@ void add_ignore(AF* af, AF* not_attacks, BitSet* mandatory, BitSet* ignored)
 
 ListNode* ee_pr_next_closure(AF* af)
 {
+	if (af_fixed_width(af))
+		return(ee_pr_next_closure_fixed_width(af));
+
     BitSet* up = create_bitset(af->size);
     BitSet* down = create_bitset(af->size);
 
-	AF* not_attacks = complement_argumentation_framework(af);
+	AF* attacked_by = get_transpose_framework(af);
 
 	BitSet* c = create_bitset(af->size);
 	BitSet* ignored = create_bitset(af->size);
-	add_ignore(af, not_attacks, c, ignored);
+	add_ignore(af, c, ignored);
+	CompatiblePrefixes* prefixes = create_compatible_prefixes(af, ignored);
 
     ListNode* first_candidate = 0;
     BitSet* new_intent = 0;
 	BitSet* prev_intent = c;
 
-    while ((new_intent = next_conflict_free_intent(not_attacks, af, prev_intent, ignored))) {
+    while ((new_intent = next_conflict_free_intent(af, attacked_by, prev_intent, prefixes))) {
 		if (prev_intent != c) {
 			free_bitset(prev_intent);
 		}
         if (!c || bitset_is_subset(c, new_intent)) {  // still on the same computational branch
-            if (is_conflict_free_set_admissible(new_intent, not_attacks, up, down)) {
+            if (is_conflict_free_set_admissible(new_intent, af, attacked_by, up, down)) {
                 if (c) {
 					free_bitset(c); // c is not maximal admissible
 				}
@@ -164,7 +176,7 @@ ListNode* ee_pr_next_closure(AF* af)
             }
         } else {    // c is maximal admissible on its computational branch
             first_candidate = add_candidate(first_candidate, c);
-			c = is_conflict_free_set_admissible(new_intent, not_attacks, up, down) ? new_intent : 0;
+			c = is_conflict_free_set_admissible(new_intent, af, attacked_by, up, down) ? new_intent : 0;
         }
 		prev_intent = new_intent;
     }
@@ -172,7 +184,8 @@ ListNode* ee_pr_next_closure(AF* af)
 		first_candidate = add_candidate(first_candidate, c);
 	}
 
-	free_argumentation_framework(not_attacks);
+	release_derived_framework(attacked_by);
+	free_compatible_prefixes(prefixes);
 	free_bitset(down);
 	free_bitset(up);
 	free_bitset(ignored);
@@ -209,8 +222,10 @@ bool advance_conflict_free_lexicographically(BitSet* s, AF* attacks)
 	SIZE_TYPE last = s->size - 1;
 
 	do {
-		while (!TEST_BIT(s, last)) {
-			--last;
+		last = bitset_prev_set_bit(s, last);
+		if (last == s->size) {
+			// no set bit left
+			return false;
 		}
 		if (last > 0) {
 			RESET_BIT(s, last);
@@ -239,18 +254,13 @@ BitSet* lexicographically_next_conflict_free_intent_(AF* not_attacks, AF* attack
 			SET_BIT(current, i);
 			down_up_arrow(not_attacks, current, next);
 
-			bool good = true;
 			// is next canonical?
-			for (SIZE_TYPE j = 0; j < i; ++j) {
-				if (TEST_BIT(next, j) && !TEST_BIT(current, j)) {
-					good = false;
-					break;
-				}
-			}
+			bool good = bitset_set_minus_is_empty_below(next, current, i);
 			if (good) {
 				// is next conflict-free?
-				for (SIZE_TYPE j = i + 1; j < attacks->size; ++j) {
-					if (TEST_BIT(next, j) && CHECK_ARG_ATTACKS_SET(attacks, j, next)) {
+				SIZE_TYPE j;
+				FOR_EACH_SET_BIT_FROM(next, j, i + 1) {
+					if (CHECK_ARG_ATTACKS_SET(attacks, j, next)) {
 						// we don't check if current attacks j, since this is impossible
 						good = false;
 						break;
@@ -281,7 +291,7 @@ BitSet* dc_pr_nextclosure(AF* af, SIZE_TYPE a)
 		swap_arguments(af, 0, a);
 	}
 
-	AF* not_attacks = complement_argumentation_framework(af);
+	AF* not_attacks = get_complement_framework(af);
 
 	BitSet* c = create_bitset(af->size);
 	set_bitset(c);
@@ -329,7 +339,7 @@ BitSet* dc_pr_nextclosure(AF* af, SIZE_TYPE a)
 		prev_intent = new_intent;
     }
 
-	free_argumentation_framework(not_attacks);
+	release_derived_framework(not_attacks);
 	free_bitset(down);
 	free_bitset(up);
 	if (new_intent) {
@@ -22,6 +22,15 @@
 
 // Computes all preferred extensions and puts them into result
 ListNode* ee_pr_next_closure(AF* af);
+
+// Adds c to the list unless c is a subset of a set in it, removes the subsets of c
+ListNode* add_candidate(ListNode* head, BitSet* c);
+
+// up and down are scratch space
+bool is_conflict_free_set_admissible(BitSet* s, AF* attacks, AF* attacked_by, BitSet* up, BitSet* down);
+
+// mandatory: the arguments in every admissible set, ignored: their victims
+void add_ignore(AF* af, BitSet* mandatory, BitSet* ignored);
 //BitSet* dc_pr_nextclosure(AF* af, SIZE_TYPE a);
 
 #endif /* AF_PREFERRED_EXTENSIONS_NC_H_ */
@@ -22,60 +22,46 @@
 #include "../af/af.h"
 #include "../bitset/bitset.h"
 #include "../../utils/linked_list.h"
-
-// Compute the next conflict-free closure coming after "current" and store it in "next"
-char next_conflict_free_closure(AF* not_attacks, AF* attacks, BitSet* current, BitSet* next) {
-	BitSet* tmp = create_bitset(attacks->size);
-
-	for (int i = not_attacks->size - 1; i >= 0; --i) {
-		if (TEST_BIT(current, i))
+#include "next_closure.h"
+#include "next_closure_fixed_width.h"
+
+// Compute the next conflict-free closure coming after "current" and store it in "next".
+// The closures are taken in the complement of attacks, attacked_by is the
+// transpose of attacks and down is scratch space. The arguments i are taken
+// from the compatible prefixes of current, so that no conflict is checked here.
+char next_conflict_free_closure(AF* attacks, AF* attacked_by, BitSet* current, BitSet* next, BitSet* down, CompatiblePrefixes* prefixes) {
+	SIZE_TYPE t = update_compatible_prefixes(prefixes, attacks, attacked_by, current);
+	SIZE_TYPE i = attacks->size;
+	while (1) {
+		i = previous_compatible_argument(prefixes, t, i);
+		if (i == attacks->size) {
+			// nothing left after the first t elements, drop the last of them
+			if (t == 0)
+				return(0);
+			--t;
+			i = prefixes->elements[t];
 			RESET_BIT(current, i);
-		else {
-			// check if i attacks i
-			if (CHECK_ARG_ATTACKS_ARG(attacks,i, i))
-				continue;
-
-			// check if argument i attacks the set current
-			if (CHECK_ARG_ATTACKS_SET(attacks, i, current))
-				continue;
-
-			// check if current attacks i
-			if (check_set_attacks_arg(attacks, current, i))
-				continue;
+			continue;
+		}
 
-			// TODO: Compare what is more efficient:
-			// The three checks above or adding "i" to "current" and checking
-			// whether the result is conflict-free
+		SET_BIT(current, i);
 
-			reset_bitset(tmp);
-			SET_BIT(current, i);
+		// compute next
+		complement_down_up_arrow_by_columns(attacks, attacked_by, current, down, next);
+		RESET_BIT(current, i);
 
-			// compute next
-			down_up_arrow(not_attacks, current, next);
-			RESET_BIT(current, i);
-
-			// TODO: optimize!
-			bitset_set_minus(next, current, tmp);
-			char canonicity_test_passed = 1;
-			for (SIZE_TYPE j = 0; j < i; ++j)
-				// check if next \ current contains a bit larger than i
-				if (TEST_BIT(tmp, j)) {
-					canonicity_test_passed = 0;
-					break;
-				}
-			if (canonicity_test_passed) {
-				free_bitset(tmp);
-				return(1);
-			}
-		}
+		// canonicity test: next \ current must not contain a bit smaller than i
+		if (bitset_set_minus_is_empty_below(next, current, i))
+			return(1);
 	}
-	free_bitset(tmp);
-	return(0);
 }
 
 ListNode* ee_st_next_closure(AF *attacks) {
+	if (af_fixed_width(attacks))
+		return(ee_st_next_closure_fixed_width(attacks));
 
-	AF *not_attacks = complement_argumentation_framework(attacks);
+	AF* attacked_by = get_transpose_framework(attacks);
+	CompatiblePrefixes* prefixes = create_compatible_prefixes(attacks, NULL);
 
 	BitSet* tmp = create_bitset(attacks->size);
 	BitSet* c = create_bitset(attacks->size);
@@ -86,11 +72,11 @@ ListNode* ee_st_next_closure(AF *attacks) {
 
 	ListNode* result_list = NULL;
 	while (1) {
-		if (!next_conflict_free_closure(not_attacks, attacks, tmp, c))
+		if (!next_conflict_free_closure(attacks, attacked_by, tmp, c, c_up, prefixes))
 			break;
 		++concept_count;
 		// up-arrow of c
-		up_arrow(not_attacks, c, c_up);
+		complement_up_arrow(attacks, c, c_up);
 
 		if (bitset_is_equal(c, c_up)) {
 			BitSet *st_ext = create_bitset(attacks->size);
@@ -107,14 +93,20 @@ ListNode* ee_st_next_closure(AF *attacks) {
 	free_bitset(tmp);
 	free_bitset(c);
 	free_bitset(c_up);
-
-	free_argumentation_framework(not_attacks);
+	free_compatible_prefixes(prefixes);
+	release_derived_framework(attacked_by);
 
 	return(result_list);
 }
 
 void se_st_next_closure(AF* attacks, BitSet* result) {
-	AF* not_attacks = complement_argumentation_framework(attacks);
+	if (af_fixed_width(attacks)) {
+		se_st_next_closure_fixed_width(attacks, result);
+		return;
+	}
+
+	AF* attacked_by = get_transpose_framework(attacks);
+	CompatiblePrefixes* prefixes = create_compatible_prefixes(attacks, NULL);
 
 	BitSet* tmp = create_bitset(attacks->size);
 	BitSet* c = create_bitset(attacks->size);
@@ -123,11 +115,11 @@ void se_st_next_closure(AF* attacks, BitSet* result) {
 	int concept_count = 0;
 
 	while (1) {
-		if (!next_conflict_free_closure(not_attacks, attacks, tmp, c))
+		if (!next_conflict_free_closure(attacks, attacked_by, tmp, c, c_up, prefixes))
 			break;
 		++concept_count;
 
-		up_arrow(not_attacks, c, c_up);
+		complement_up_arrow(attacks, c, c_up);
 
 		if (bitset_is_equal(c, c_up)) {
 			copy_bitset(c, result);
@@ -139,7 +131,8 @@ void se_st_next_closure(AF* attacks, BitSet* result) {
 	free_bitset(tmp);
 	free_bitset(c);
 	free_bitset(c_up);
-	free_argumentation_framework(not_attacks);
+	free_compatible_prefixes(prefixes);
+	release_derived_framework(attacked_by);
 	return;
 }
 
@@ -147,7 +140,7 @@ void dc_st_next_closure(AF* attacks, int argument, BitSet* result) {
 	if (CHECK_ARG_ATTACKS_ARG(attacks, argument, argument))
 		return;
 
-	int i;
+	SIZE_TYPE i;
 	int *mapping = (int *) calloc(attacks->size, sizeof(int));
 	assert(mapping != NULL);
 	// first fill the mapping with the usual indices
@@ -160,7 +153,6 @@ void dc_st_next_closure(AF* attacks, int argument, BitSet* result) {
 	BitSet* mask = create_bitset(attacks->size);
 	for (i = 0; i < attacks->size; ++i) {
 		if ((CHECK_ARG_ATTACKS_ARG(attacks, i, argument) || CHECK_ARG_ATTACKS_ARG(attacks, argument, i))) {
-			printf("i: %d\n", i);
 			temp = mapping[p];
 			mapping[p] = mapping[i];
 			mapping[i] = temp;
@@ -176,12 +168,6 @@ void dc_st_next_closure(AF* attacks, int argument, BitSet* result) {
 	mapping[p] = argument;
 	mapping[index_argument] = temp;
 
-	// display the mapping
-	printf("Mapping: ");
-	 for (i = 0; i < attacks->size; ++i)
-	  	printf("%d ", mapping[i]);
-	  printf("\n");
-
 	AF *attacks_mapped = create_argumentation_framework(attacks->size);
 	// fill in the new af according to the mapping
 	int j;
@@ -192,36 +178,33 @@ void dc_st_next_closure(AF* attacks, int argument, BitSet* result) {
 		}
 	}
 
-	// complement of the mapped attacks relation
-	AF* not_attacks_mapped = complement_argumentation_framework(attacks_mapped);
-
-	// print_argumentation_framework(not_attacks_mapped);
+	AF* attacked_by = get_transpose_framework(attacks_mapped);
+	CompatiblePrefixes* prefixes = create_compatible_prefixes(attacks_mapped, NULL);
 
 	BitSet* tmp = create_bitset(attacks->size);
-	// set the argument bit. this is the starting point
-	// SET_BIT(tmp, mapping[argument]);
-	SET_BIT(tmp, p);
 	BitSet* c = create_bitset(attacks->size);
 	BitSet* c_up = create_bitset(attacks->size);
 
 	int concept_count = 0;
 
-	print_bitset(tmp, stdout);
-	printf("\n");
-	while (is_bitset_intersection_empty(tmp, mask)) {
-		if (!next_conflict_free_closure(not_attacks_mapped, attacks_mapped, tmp, c))
-			break;
+	// The closures that start with the argument, in lectic order: the first
+	// is the closure of the argument, the next ones follow until a closure
+	// contains one of the conflicting arguments in front. A stable extension
+	// with the argument is one of them, and it contains the closure of the
+	// argument, so a conflict there means there is none.
+	SET_BIT(tmp, p);
+	complement_down_up_arrow_by_columns(attacks_mapped, attacked_by, tmp, c_up, c);
+	char found = is_set_conflict_free(attacks_mapped, c);
+	for (; found && is_bitset_intersection_empty(c, mask);
+		   found = next_conflict_free_closure(attacks_mapped, attacked_by, tmp, c, c_up, prefixes)) {
 		++concept_count;
 
-		up_arrow(not_attacks_mapped, c, c_up);
+		complement_up_arrow(attacks_mapped, c, c_up);
 
 		if (bitset_is_equal(c, c_up)) {
-			// TODO:
-			// indices of result need to be mapped back to original indices
-			for (i = 0; i < c->size; ++i)
-				if (TEST_BIT(c, i))
-					SET_BIT(result, mapping[i]);
-			// copy_bitset(c, result);
+			// map the indices back to those of attacks
+			FOR_EACH_SET_BIT(c, i)
+				SET_BIT(result, mapping[i]);
 			break;
 		}
 		copy_bitset(c, tmp);
@@ -230,6 +213,9 @@ void dc_st_next_closure(AF* attacks, int argument, BitSet* result) {
 	free_bitset(tmp);
 	free_bitset(c);
 	free_bitset(c_up);
+	free_compatible_prefixes(prefixes);
+	release_derived_framework(attacked_by);
 	free_argumentation_framework(attacks_mapped);
-	free_argumentation_framework(not_attacks_mapped);
+	free_bitset(mask);
+	free(mapping);
 }
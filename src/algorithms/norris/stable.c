@@ -18,24 +18,72 @@ typedef struct concept Concept;
 
 int concept_count = 0;
 
-Concept* create_concept(BitSet* extent, BitSet* intent, BitSet* not_attacked) {
+// The concepts of the list are removed in no particular order, so they are not
+// taken from a BitSetArena, whose bitsets are released in stack order.
+// Instead a removed concept keeps its bitsets and is put into a pool, and a
+// new concept is taken from there. Once the list has reached its largest
+// size, no bitsets are allocated.
+static Concept** concept_pool = NULL;
+static size_t concept_pool_count = 0, concept_pool_capacity = 0;
+
+// A concept with uninitialized bitsets of the given size
+Concept* create_concept(SIZE_TYPE size) {
+	if (concept_pool_count > 0)
+		return(concept_pool[--concept_pool_count]);
+
 	Concept* c = (Concept*) calloc(1, sizeof(Concept));
 	assert(c != NULL);
-	c->extent = extent;
-	c->intent = intent;
-	c->not_attacked = not_attacked;
-	++concept_count;
+	c->extent = create_bitset(size);
+	c->intent = create_bitset(size);
+	c->not_attacked = create_bitset(size);
 	return(c);
 }
 
+// Put c into the pool
 void free_concept(AF *af, Concept *c) {
-	free_bitset(c->extent);
-	free_bitset(c->intent);
-	free_bitset(c->not_attacked);
-	free(c);
+	if (concept_pool_count == concept_pool_capacity) {
+		concept_pool_capacity = concept_pool_capacity ? 2 * concept_pool_capacity : 64;
+		concept_pool = realloc(concept_pool, concept_pool_capacity * sizeof(Concept*));
+		assert(concept_pool != NULL);
+	}
+	concept_pool[concept_pool_count++] = c;
+}
+
+// Put the concepts of the list into the pool, the nodes are freed
+void free_concept_list(AF *af, ListNode *head) {
+	while (head) {
+		ListNode *next = head->next;
+		free_concept(af, head->c);
+		free_list_node(head);
+		head = next;
+	}
+}
+
+// Free the concepts of the list and of the pool
+void free_concepts(AF *af, ListNode *head) {
+	free_concept_list(af, head);
+	for (size_t k = 0; k < concept_pool_count; ++k) {
+		free_bitset(concept_pool[k]->extent);
+		free_bitset(concept_pool[k]->intent);
+		free_bitset(concept_pool[k]->not_attacked);
+		free(concept_pool[k]);
+	}
+	free(concept_pool);
+	concept_pool = NULL;
+	concept_pool_count = concept_pool_capacity = 0;
 }
 
-int add_one(AF* not_attacks, SIZE_TYPE i, ListNode **phead , BitSet** argument_extents, FILE *outfile) {
+// The concept of the empty intent
+Concept* create_top_concept(SIZE_TYPE size) {
+	Concept* c = create_concept(size);
+	++concept_count;
+	reset_bitset(c->intent);
+	set_bitset(c->extent);
+	set_bitset(c->not_attacked);
+	return(c);
+}
+
+int add_one(AF* attacks, SIZE_TYPE i, ListNode **phead , BitSet** argument_attackers, FILE *outfile) {
     ListNode *head = *phead;
 	ListNode *prev = NULL;
 	ListNode *cur = head;
@@ -43,30 +91,28 @@ int add_one(AF* not_attacks, SIZE_TYPE i, ListNode **phead , BitSet** argument_e
 	// new concepts
 	ListNode *new_head = NULL;
 
-	BitSet *conflict_free = create_bitset(not_attacks->size);
-
 	while (cur) {
 		Concept *c = cur->c;
-		bitset_intersection(c->extent, c->not_attacked, conflict_free);
-		if (TEST_BIT(conflict_free, i)) {
+		if (TEST_BIT(c->extent, i) && TEST_BIT(c->not_attacked, i)) {
 			// c->intent U {i} is a conflict-free superset of c->intent
 			// print_bitset(c->intent, stdout);
 			// printf("\n");
 
-			if (bitset_is_subset(c->extent, argument_extents[i])) {
+			if (is_bitset_intersection_empty(c->extent, argument_attackers[i])) {
 				// update c
 				SET_BIT(c->intent, i);
-				bitset_intersection(c->not_attacked, not_attacks->graph[i], c->not_attacked);
+				bitset_set_minus(c->not_attacked, attacks->graph[i], c->not_attacked);
 
 				char remove_cur = 0;
 				if (bitset_is_equal(c->intent, c->not_attacked)) {
 					// c->intent is a stable extension
 					print_set(c->intent, outfile, "\n");
-					remove_cur = 1;
+					free_concept_list(attacks, new_head);
+					*phead = head;
 					return(1);
 				} else {
-					bitset_intersection(conflict_free, not_attacks->graph[i], conflict_free);
-					if (bitset_is_equal(conflict_free, c->intent)) {
+					// c->not_attacked is already intersected with the row of i
+					if (bitset_is_intersection_equal(c->extent, c->not_attacked, c->intent)) {
 						remove_cur = 1;
 					}
 				}
@@ -75,65 +121,54 @@ int add_one(AF* not_attacks, SIZE_TYPE i, ListNode **phead , BitSet** argument_e
 					cur = cur->next;
 					// remove cur from the concept list
 					if (prev) {
-						free_concept(not_attacks, prev->next->c);
+						free_concept(attacks, prev->next->c);
 						free_list_node(prev->next);
 						prev->next = cur;
 					} else {
-						free_concept(not_attacks, head->c);
+						free_concept(attacks, head->c);
 						free_list_node(head);
 						head = cur;
 					}
 					continue;
 				}
 			} else {
-				// create a new concept
-				BitSet *new_extent = create_bitset(not_attacks->size);
-				bitset_intersection(c->extent, argument_extents[i], new_extent);
-
-				// "lectic-order test"
+				// create a new concept, if the "lectic-order test" on the new
+				// extent c->extent \ argument_attackers[i] succeeds
 				char is_new_intent_closed = 1;
-				for (SIZE_TYPE j = 0; j < i; ++j) {
-					if (!(TEST_BIT((c->intent),j)) && (bitset_is_subset(new_extent, argument_extents[j]))) {
+				for (SIZE_TYPE j = bitset_next_clear_bit(c->intent, 0); j < i; j = bitset_next_clear_bit(c->intent, j + 1)) {
+					if (bitset_is_set_minus_disjoint(c->extent, argument_attackers[i], argument_attackers[j])) {
 						is_new_intent_closed = 0;
-						free_bitset(new_extent);
 						break;
 					}
 				}
 
 				if (is_new_intent_closed) {
-					BitSet* new_intent = create_bitset(not_attacks->size);
-					copy_bitset(c->intent, new_intent);
-					SET_BIT(new_intent, i);
+					Concept *new_concept = create_concept(attacks->size);
+					bitset_set_minus(c->extent, argument_attackers[i], new_concept->extent);
 
-					BitSet* new_not_attacked = create_bitset(not_attacks->size);
-					bitset_intersection(c->not_attacked, not_attacks->graph[i], new_not_attacked);
+					copy_bitset(c->intent, new_concept->intent);
+					SET_BIT(new_concept->intent, i);
 
-					if (bitset_is_equal(new_intent, new_not_attacked)) {
+					bitset_set_minus(c->not_attacked, attacks->graph[i], new_concept->not_attacked);
+
+					if (bitset_is_equal(new_concept->intent, new_concept->not_attacked)) {
 						// new_intent is a stable extension
-						print_set(new_intent, outfile, "\n");
-						// TODO: deallocate memory for new_*
-						free_bitset(new_intent);
-						free_bitset(new_extent);
-						free_bitset(new_not_attacked);
+						print_set(new_concept->intent, outfile, "\n");
+						free_concept(attacks, new_concept);
+						free_concept_list(attacks, new_head);
+						*phead = head;
 						return(1);
 					} else {
-						BitSet* new_conflict_free = create_bitset(not_attacks->size);
-						bitset_intersection(new_extent, new_not_attacked, new_conflict_free);
-
-						if (!bitset_is_equal(new_conflict_free, new_intent)) {
-							Concept *new_concept = create_concept(new_extent, new_intent, new_not_attacked);
+						if (!bitset_is_intersection_equal(new_concept->extent, new_concept->not_attacked, new_concept->intent)) {
 							ListNode *new_node = create_list_node(new_concept);
+							++concept_count;
 							if (new_head) {
 								new_node->next = new_head;
 							}
 							new_head = new_node;
 						}
 						else {
-							// deallocate memory for new_*
-							free_bitset(new_intent);
-							free_bitset(new_extent);
-							free_bitset(new_not_attacked);
-							free_bitset(new_conflict_free);
+							free_concept(attacks, new_concept);
 						}
 					} // closed but not stable
 				} // closed
@@ -145,53 +180,32 @@ int add_one(AF* not_attacks, SIZE_TYPE i, ListNode **phead , BitSet** argument_e
 	if (prev) {
 		prev->next = new_head;
 	}
-    phead = &head;
+	*phead = head;
 
 	return(0);
 }
 
 void se_st_norris(AF* attacks, FILE *outfile) {
 	concept_count = 0;
-	AF *not_attacks = complement_argumentation_framework(attacks);
-
-	BitSet* argument_extents[attacks->size];
-	for (SIZE_TYPE i = 0; i < not_attacks->size; ++i) {
-		argument_extents[i] = create_bitset(not_attacks->size);
-		for (SIZE_TYPE j = 0; j < not_attacks->size; ++j) {
-			if (TEST_BIT(not_attacks->graph[j], i)) {
-				SET_BIT(argument_extents[i], j);
-			}
-		}
-	}
+	// The extent of argument i is the complement of its attackers, the
+	// concepts are computed on the rows of attacks and its transpose.
+	AF* attacked_by = get_transpose_framework(attacks);
+	BitSet** argument_attackers = attacked_by->graph;
+
+	ListNode* head = create_list_node(create_top_concept(attacks->size));
 
-	BitSet* intent = create_bitset(attacks->size);  // empty set
-	BitSet* extent = create_bitset(attacks->size);
-    for (SIZE_TYPE i = 0; i < attacks->size; ++i) {       // full set
-        SET_BIT(extent, i);
-    }
-	BitSet* not_attacked = create_bitset(attacks->size);
-	copy_bitset(extent, not_attacked);
-	BitSet* conflict_free = create_bitset(attacks->size);
-	copy_bitset(extent, conflict_free);
-	Concept* c = create_concept(extent, intent, not_attacked);
-	ListNode* head = create_list_node(c);
-
-	for (SIZE_TYPE i = 0; i < not_attacks->size; ++i) {
-		if (add_one(not_attacks, i, &head, argument_extents, outfile))
+	for (SIZE_TYPE i = 0; i < attacks->size; ++i) {
+		if (add_one(attacks, i, &head, argument_attackers, outfile))
 			break;
 	}
 
 	printf("Number of created concepts: %d\n", concept_count);
 
-	free_concept(attacks, c);
-	free_list_node(head);
-	for (SIZE_TYPE i = 0; i < not_attacks->size; ++i)
-		free_bitset(argument_extents[i]);
-
-	free_argumentation_framework(not_attacks);
+	free_concepts(attacks, head);
+	release_derived_framework(attacked_by);
 }
 
-ListNode* add_to_list(AF* not_attacks, SIZE_TYPE i, ListNode **phead , BitSet** argument_extents, ListNode *extensions) {
+ListNode* add_to_list(AF* attacks, SIZE_TYPE i, ListNode **phead , BitSet** argument_attackers, ListNode *extensions) {
     ListNode *head = *phead;
 	ListNode *prev = NULL;
 	ListNode *cur = head;
@@ -199,18 +213,15 @@ ListNode* add_to_list(AF* not_attacks, SIZE_TYPE i, ListNode **phead , BitSet**
 	// new concepts
 	ListNode *new_head = NULL;
 
-	BitSet *conflict_free = create_bitset(not_attacks->size);
-
 	while (cur) {
 		Concept *c = cur->c;
-		bitset_intersection(c->extent, c->not_attacked, conflict_free);
-		if (TEST_BIT(conflict_free, i)) {
+		if (TEST_BIT(c->extent, i) && TEST_BIT(c->not_attacked, i)) {
 			// c->intent U {i} is a conflict-free superset of c->intent
 
-			if (bitset_is_subset(c->extent, argument_extents[i])) {
+			if (is_bitset_intersection_empty(c->extent, argument_attackers[i])) {
 				// update c
 				SET_BIT(c->intent, i);
-				bitset_intersection(c->not_attacked, not_attacks->graph[i], c->not_attacked);
+				bitset_set_minus(c->not_attacked, attacks->graph[i], c->not_attacked);
 
 				char remove_cur = 0;
 				if (bitset_is_equal(c->intent, c->not_attacked)) {
@@ -221,8 +232,8 @@ ListNode* add_to_list(AF* not_attacks, SIZE_TYPE i, ListNode **phead , BitSet**
 					extensions = insert_list_node(intent, extensions);
 					remove_cur = 1;
 				} else {
-					bitset_intersection(conflict_free, not_attacks->graph[i], conflict_free);
-					if (bitset_is_equal(conflict_free, c->intent)) {
+					// c->not_attacked is already intersected with the row of i
+					if (bitset_is_intersection_equal(c->extent, c->not_attacked, c->intent)) {
 						remove_cur = 1;
 					}
 				}
@@ -231,64 +242,53 @@ ListNode* add_to_list(AF* not_attacks, SIZE_TYPE i, ListNode **phead , BitSet**
 					cur = cur->next;
 					// remove cur from the concept list
 					if (prev) {
-						free_concept(not_attacks, prev->next->c);
+						free_concept(attacks, prev->next->c);
 						free_list_node(prev->next);
 						prev->next = cur;
 					} else if (cur) {
-						free_concept(not_attacks, head->c);
+						free_concept(attacks, head->c);
 						free_list_node(head);
 						head = cur;
 					}
 					continue;
 				}
 			} else {
-				// create a new concept
-				BitSet *new_extent = create_bitset(not_attacks->size);
-				bitset_intersection(c->extent, argument_extents[i], new_extent);
-
-				// "lectic-order test"
+				// create a new concept, if the "lectic-order test" on the new
+				// extent c->extent \ argument_attackers[i] succeeds
 				char is_new_intent_closed = 1;
-				for (SIZE_TYPE j = 0; j < i; ++j) {
-					if (!(TEST_BIT((c->intent),j)) && (bitset_is_subset(new_extent, argument_extents[j]))) {
+				for (SIZE_TYPE j = bitset_next_clear_bit(c->intent, 0); j < i; j = bitset_next_clear_bit(c->intent, j + 1)) {
+					if (bitset_is_set_minus_disjoint(c->extent, argument_attackers[i], argument_attackers[j])) {
 						is_new_intent_closed = 0;
-						free_bitset(new_extent);
 						break;
 					}
 				}
 
 				if (is_new_intent_closed) {
-					BitSet* new_intent = create_bitset(not_attacks->size);
-					copy_bitset(c->intent, new_intent);
-					SET_BIT(new_intent, i);
+					Concept *new_concept = create_concept(attacks->size);
+					bitset_set_minus(c->extent, argument_attackers[i], new_concept->extent);
+
+					copy_bitset(c->intent, new_concept->intent);
+					SET_BIT(new_concept->intent, i);
 
-					BitSet* new_not_attacked = create_bitset(not_attacks->size);
-					bitset_intersection(c->not_attacked, not_attacks->graph[i], new_not_attacked);
+					bitset_set_minus(c->not_attacked, attacks->graph[i], new_concept->not_attacked);
 
-					if (bitset_is_equal(new_intent, new_not_attacked)) {
+					if (bitset_is_equal(new_concept->intent, new_concept->not_attacked)) {
 						// new_intent is a stable extension
-						// insert_bitset(new_intent, extensions);
-						extensions = insert_list_node(new_intent, extensions);
-						// TODO: deallocate memory for new_*
-						free_bitset(new_extent);
-						free_bitset(new_not_attacked);
+						BitSet* intent = create_bitset(attacks->size);
+						copy_bitset(new_concept->intent, intent);
+						extensions = insert_list_node(intent, extensions);
+						free_concept(attacks, new_concept);
 					} else {
-						BitSet* new_conflict_free = create_bitset(not_attacks->size);
-						bitset_intersection(new_extent, new_not_attacked, new_conflict_free);
-
-						if (!bitset_is_equal(new_conflict_free, new_intent)) {
-							Concept *new_concept = create_concept(new_extent, new_intent, new_not_attacked);
+						if (!bitset_is_intersection_equal(new_concept->extent, new_concept->not_attacked, new_concept->intent)) {
 							ListNode *new_node = create_list_node(new_concept);
+							++concept_count;
 							if (new_head) {
 								new_node->next = new_head;
 							}
 							new_head = new_node;
 						}
 						else {
-							// deallocate memory for new_*
-							free_bitset(new_intent);
-							free_bitset(new_extent);
-							free_bitset(new_not_attacked);
-							free_bitset(new_conflict_free);
+							free_concept(attacks, new_concept);
 						}
 					} // closed but not stable
 				} // closed
@@ -300,7 +300,7 @@ ListNode* add_to_list(AF* not_attacks, SIZE_TYPE i, ListNode **phead , BitSet**
 	if (prev) {
 		prev->next = new_head;
 	}
-    phead = &head;
+	*phead = head;
 
 	return(extensions);
 }
@@ -309,40 +309,21 @@ ListNode* add_to_list(AF* not_attacks, SIZE_TYPE i, ListNode **phead , BitSet**
 ListNode* ee_st_norris(AF* attacks)
 {
 	concept_count = 0;
-	AF* not_attacks = complement_argumentation_framework(attacks);
-
-	BitSet* argument_extents[attacks->size];
-	for (SIZE_TYPE i = 0; i < not_attacks->size; ++i) {
-		argument_extents[i] = create_bitset(not_attacks->size);
-		for (SIZE_TYPE j = 0; j < not_attacks->size; ++j) {
-			if (TEST_BIT(not_attacks->graph[j], i)) {
-				SET_BIT(argument_extents[i], j);
-			}
-		}
-	}
+	// The extent of argument i is the complement of its attackers, the
+	// concepts are computed on the rows of attacks and its transpose.
+	AF* attacked_by = get_transpose_framework(attacks);
+	BitSet** argument_attackers = attacked_by->graph;
 
-	BitSet* intent = create_bitset(attacks->size);  // empty set
-	BitSet* extent = create_bitset(attacks->size);
-    for (SIZE_TYPE i = 0; i < attacks->size; ++i) {       // full set
-        SET_BIT(extent, i);
-    }
-	BitSet* not_attacked = create_bitset(attacks->size);
-	copy_bitset(extent, not_attacked);
-	Concept* c = create_concept(extent, intent, not_attacked);
-	ListNode* head = create_list_node(c);
+	ListNode* head = create_list_node(create_top_concept(attacks->size));
 
 	ListNode* extensions = NULL;
-	for (SIZE_TYPE i = 0; i < not_attacks->size; ++i) {
+	for (SIZE_TYPE i = 0; i < attacks->size; ++i) {
 		// printf("\ni = %d, concepts = %d\n", i, concept_count);
-		extensions = add_to_list(not_attacks, i, &head, argument_extents, extensions);
+		extensions = add_to_list(attacks, i, &head, argument_attackers, extensions);
 	}
 
-	free_concept(attacks, c);
-	free_list_node(head);
-	for (SIZE_TYPE i = 0; i < not_attacks->size; ++i)
-		free_bitset(argument_extents[i]);
-
-	free_argumentation_framework(not_attacks);
+	free_concepts(attacks, head);
+	release_derived_framework(attacked_by);
 
 	return(extensions);
 }
@@ -26,19 +26,8 @@ Concept* create_concept_bu(BitSet* extent, BitSet* intent) {
 }
 
 
-void arrow_up(AF* af, BitSet* s, BitSet* r) {
-    for (SIZE_TYPE i = 0; i < af->size; ++i) {  // full set
-        	SET_BIT(r, i);
-	}
-	for (SIZE_TYPE i = 0; i < af->size; ++i) {
-		if (TEST_BIT(s, i)) {
-			bitset_intersection(r, af->graph[i], r);
-		}
-	}
-}
-
-
-void add_to_list_bu(AF* not_attacks, SIZE_TYPE i, ListNode** phead , ListNode** pextensions) {
+// The concepts of the complement of attacks, computed on the rows of attacks
+void add_to_list_bu(AF* attacks, SIZE_TYPE i, ListNode** phead , ListNode** pextensions) {
     ListNode* extensions = *pextensions;
 
     ListNode* head = *phead;
@@ -47,18 +36,18 @@ void add_to_list_bu(AF* not_attacks, SIZE_TYPE i, ListNode** phead , ListNode**
 	while (cur) {
 		Concept *c = cur->c;
 
-		if (bitset_is_subset(c->intent, not_attacks->graph[i])) {
+		if (is_bitset_intersection_empty(c->intent, attacks->graph[i])) {
 			// update c
 			SET_BIT(c->extent, i);
 		} else {
 			// create a new concept
-			BitSet *new_intent = create_bitset(not_attacks->size);
-			bitset_intersection(c->intent, not_attacks->graph[i], new_intent);
+			BitSet *new_intent = create_bitset(attacks->size);
+			bitset_set_minus(c->intent, attacks->graph[i], new_intent);
 
 			// "lectic-order test"
 			bool is_new_extent_closed = true;
 			for (SIZE_TYPE j = 0; j < i; ++j) {
-				if (!TEST_BIT(c->extent, j) && bitset_is_subset(new_intent, not_attacks->graph[j])) {
+				if (!TEST_BIT(c->extent, j) && is_bitset_intersection_empty(new_intent, attacks->graph[j])) {
 					is_new_extent_closed = false;
 					free_bitset(new_intent);
 					break;
@@ -66,15 +55,15 @@ void add_to_list_bu(AF* not_attacks, SIZE_TYPE i, ListNode** phead , ListNode**
 			}
 
 			if (is_new_extent_closed) {
-                BitSet* up = create_bitset(not_attacks->size);
-                arrow_up(not_attacks, new_intent, up);
+                BitSet* up = create_bitset(attacks->size);
+                complement_up_arrow(attacks, new_intent, up);
 
 				if (bitset_is_equal(new_intent, up)) {  // new_intent is stable
                     ListNode* ext = create_list_node(new_intent);
                     ext->next = extensions;
                     extensions = ext;
 				} else if (bitset_is_subset(up, new_intent)) {	// new_intent is a dominating set
-					BitSet* new_extent = create_bitset(not_attacks->size);
+					BitSet* new_extent = create_bitset(attacks->size);
 					copy_bitset(c->extent, new_extent);
 					SET_BIT(new_extent, i);
 
@@ -107,13 +96,11 @@ ListNode* enumerate_stable_extensions_norris_bottom_up(AF* af)
 
 	ListNode* head = create_list_node(create_concept_bu(create_bitset(af->size), intent));
 
-	AF* not_attacks = complement_argumentation_framework(af);
 	ListNode* extensions = NULL;
-	for (SIZE_TYPE i = 0; i < not_attacks->size; ++i) {
+	for (SIZE_TYPE i = 0; i < af->size; ++i) {
 		printf("\ni = %d, concepts = %d\n", i, concept_count_bu);
-		add_to_list_bu(not_attacks, i, &head, &extensions);
+		add_to_list_bu(af, i, &head, &extensions);
 	}
-	free_argumentation_framework(not_attacks);
 
 	printf("Number of created concepts: %d\n", concept_count_bu);
 
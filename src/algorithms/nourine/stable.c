@@ -636,9 +636,21 @@ SIZE_TYPE count_conflicts(AF* conflicts)
 	return count;
 }
 
+// The complement of a dominating closure is a stable extension if it is
+// conflict-free and attacks every argument of the closure. The closures do not
+// always ensure the latter, e.g. for an argument attacked only by a
+// self-attacking one. victims is scratch space.
+static bool is_complement_stable(AF* attacks, BitSet* closure, BitSet* complement, BitSet* victims)
+{
+	if (!is_set_conflict_free(attacks, complement))
+		return(false);
+	get_victims(attacks, complement, victims);
+	return(bitset_is_subset(closure, victims));
+}
+
 ListNode* ee_st_nourine(AF* attacks)
 {
-	AF* attacked = transpose_argumentation_framework(attacks);
+	AF* attacked = get_transpose_framework(attacks);
 	AF* conflicts = create_conflict_framework(attacks);
 	UnitImplicationNode* imps = create_unit_implications(attacks, attacked, conflicts);
 	do {
@@ -650,30 +662,32 @@ ListNode* ee_st_nourine(AF* attacks)
 	unit_close(closure, imps);
 
 	BitSet* complement = create_bitset(attacks->size);
+	BitSet* victims = create_bitset(attacks->size);
 
 	ListNode* result_list = NULL;
 	do {
 		// print_bitset(closure, stdout);
 		// printf("\n");
 		complement_bitset(closure, complement);
-		if (is_set_conflict_free(attacks, complement)) {
+		if (is_complement_stable(attacks, closure, complement, victims)) {
 			BitSet *x = create_bitset(attacks->size);
 			copy_bitset(complement, x);
 			result_list = insert_list_node(x, result_list);
 		}
 	} while (next_dominating_closure(closure, imps, attacked));
 
-	free_argumentation_framework(attacked);
+	release_derived_framework(attacked);
 	free_argumentation_framework(conflicts);
 	free_bitset(closure);
 	free_bitset(complement);
+	free_bitset(victims);
 	free_unit_implication_node(imps, true, true);
 
 	return(result_list);
 }
 
 ListNode* enumerate_stable_extensions_via_implications(AF* attacks) {
-	AF* attacked = transpose_argumentation_framework(attacks);
+	AF* attacked = get_transpose_framework(attacks);
 	AF* conflicts = create_conflict_framework(attacks);
 	UnitImplicationNode* imps = create_unit_implications(attacks, attacked, conflicts);
 	do {
@@ -687,9 +701,10 @@ ListNode* enumerate_stable_extensions_via_implications(AF* attacks) {
 	ListNode* head = NULL;
 	if (count_bits(closure) < closure->size) {
 		BitSet* complement = create_bitset(attacks->size);
+		BitSet* victims = create_bitset(attacks->size);
 		do {
 			complement_bitset(closure, complement);
-			if (is_set_conflict_free(attacks, complement)) {
+			if (is_complement_stable(attacks, closure, complement, victims)) {
 				BitSet* extension = create_bitset(complement->size);
 				copy_bitset(complement, extension);
 				ListNode* node = create_list_node(extension);
@@ -698,9 +713,10 @@ ListNode* enumerate_stable_extensions_via_implications(AF* attacks) {
 			}
 		} while (next_dominating_closure(closure, imps, attacked));
 		free_bitset(complement);
+		free_bitset(victims);
 	}
 
-	free_argumentation_framework(attacked);
+	release_derived_framework(attacked);
 	free_argumentation_framework(conflicts);
 	free_bitset(closure);
 	free_unit_implication_node(imps, true, true);
@@ -709,7 +725,7 @@ ListNode* enumerate_stable_extensions_via_implications(AF* attacks) {
 }
 
 void se_st_nourine(AF* attacks, BitSet* result) {
-	AF* attacked = transpose_argumentation_framework(attacks);
+	AF* attacked = get_transpose_framework(attacks);
 	AF* conflicts = create_conflict_framework(attacks);
 	UnitImplicationNode* imps = create_unit_implications(attacks, attacked, conflicts);
 	do {
@@ -723,23 +739,27 @@ void se_st_nourine(AF* attacks, BitSet* result) {
 	unit_close(closure, imps);
 
 	BitSet* complement = create_bitset(attacks->size);
+	BitSet* victims = create_bitset(attacks->size);
 	int closure_count = 0;
 	do {
 		++closure_count;
 		// print_bitset(closure, stdout);
 		// printf("\n");
 		complement_bitset(closure, complement);
-		if (is_set_conflict_free(attacks, complement)) {
-			free_argumentation_framework(attacked);
-			free_argumentation_framework(conflicts);
-			free_bitset(closure);
-			free_unit_implication_node(imps, true, true);
+		if (is_complement_stable(attacks, closure, complement, victims)) {
 			printf("Closure count: %d\n", closure_count);
 			copy_bitset(complement, result);
 			break;
 			// return(complement);
 		}
 	} while (next_dominating_closure(closure, imps, attacked));
+
+	release_derived_framework(attacked);
+	free_argumentation_framework(conflicts);
+	free_bitset(closure);
+	free_bitset(complement);
+	free_bitset(victims);
+	free_unit_implication_node(imps, true, true);
 	return;
 }
 
@@ -23,20 +23,21 @@
 
 BitSet* create_bitset(SIZE_TYPE size) {
 
-	BitSet* bs = (BitSet*) calloc(1,  sizeof(BitSet));
+	SIZE_TYPE base_count = (size + BITSET_BASE_SIZE - 1) / BITSET_BASE_SIZE;
+
+	// the elements are stored right after the header, in the same allocation
+	BitSet* bs = (BitSet*) calloc(1,  sizeof(BitSet) + base_count * sizeof(BITSET_BASE_TYPE));
 	assert(bs != NULL);
 
 	bs->size = size;
-	bs->base_count = (int) ceilf((double) bs->size / BITSET_BASE_SIZE);
-	bs->elements = (BITSET_BASE_TYPE*) calloc(bs->base_count,  sizeof(BITSET_BASE_TYPE));
-	assert(bs->elements != NULL);
+	bs->base_count = base_count;
+	bs->elements = (BITSET_BASE_TYPE*) (bs + 1);
 
 	return(bs);
 }
 
 int free_bitset(BitSet* bs) {
 	int freed_bytes = bs->base_count * sizeof(BITSET_BASE_TYPE);
-	free(bs->elements);
 	free(bs);
 	return(freed_bytes);
 }
@@ -50,10 +51,11 @@ void print_bitset(BitSet* bs, FILE *outfile) {
 }
 
 void print_set(BitSet* bs, FILE *outfile, const char *end) {
+	SIZE_TYPE i;
+
 	fprintf(outfile, "[ ");
-	for (SIZE_TYPE i = 0; i < bs->size; ++i)
-		if (TEST_BIT(bs, i))
-			fprintf(outfile, "%d ", i+1);
+	FOR_EACH_SET_BIT(bs, i)
+		fprintf(outfile, "%d ", i+1);
 	fprintf(outfile, "]%s", end);
 }
 
@@ -65,3 +67,37 @@ void print_set(BitSet* bs, FILE *outfile, const char *end) {
 // 			++l;
 // 	return(l);
 // }
+
+extern inline char bitset_is_equal(BitSet* bs1, BitSet* bs2);
+
+extern inline char is_bitset_intersection_empty(BitSet* bs1, BitSet* bs2);
+
+extern inline void bitset_union(BitSet* bs1, BitSet* bs2, BitSet* r);
+
+extern inline BITSET_BASE_TYPE get_last_full_block(BitSet* bs);
+
+extern inline void complement_bitset(BitSet* bs, BitSet* r);
+
+extern inline void reset_bitset(BitSet* bs);
+
+extern inline void bitset_set_minus(BitSet* bs1, BitSet* bs2, BitSet* r);
+
+extern inline void copy_bitset(BitSet* bs1, BitSet* bs2);
+
+extern inline char bitset_is_fullset(BitSet* bs);
+
+extern inline char bitset_is_emptyset(BitSet* bs);
+
+extern inline SIZE_TYPE count_bits(BitSet* bs);
+
+extern inline void set_bitset(BitSet* bs);
+
+extern inline BITSET_BASE_TYPE get_key(BitSet* bs);
+
+extern inline SIZE_TYPE bitset_next_set_bit(BitSet* bs, SIZE_TYPE k);
+
+extern inline SIZE_TYPE bitset_next_clear_bit(BitSet* bs, SIZE_TYPE k);
+
+extern inline SIZE_TYPE bitset_next_set_minus_bit(BitSet* bs1, BitSet* bs2, SIZE_TYPE k);
+
+extern inline SIZE_TYPE bitset_prev_set_bit(BitSet* bs, SIZE_TYPE k);
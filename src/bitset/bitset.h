@@ -31,10 +31,10 @@ typedef unsigned int SIZE_TYPE;
 
 typedef struct bitset BitSet;
 
-// A BitSet is an array of BITSET_BASE_TYPE
+// A BitSet is an array of BITSET_BASE_TYPE, allocated together with the header
 struct bitset {
 	SIZE_TYPE size;
-	unsigned short base_count;
+	SIZE_TYPE base_count;
 	BITSET_BASE_TYPE* elements;
 };
 
@@ -51,6 +51,38 @@ void print_set(BitSet* bs, FILE *f, const char *end);
 // Print the given bitset as set
 void print_bitset(BitSet* bs, FILE *f);
 
+// Kernels for the word loops of the set operations below. The scalar kernels
+// are the default, vectorized ones are selected at startup depending on the
+// instruction sets supported by the CPU (see bitset_simd.c).
+enum bitset_kernel_type {BITSET_KERNEL_SCALAR, BITSET_KERNEL_SSE4, BITSET_KERNEL_AVX2, BITSET_KERNEL_AVX512};
+
+struct bitset_kernels {
+	enum bitset_kernel_type type;
+	char (*is_subset)(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, SIZE_TYPE n);
+	char (*is_intersection_empty)(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, SIZE_TYPE n);
+	void (*intersection)(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n);
+	void (*unite)(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n);
+	void (*set_minus)(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n);
+	// Transpose the count adjacent 64x64 bit blocks of a strip of a bit
+	// matrix. Row r of the strip starts at src + r * stride, only the first
+	// rows rows are read, the others are taken as empty. Transposed block b
+	// is written to the 64 base elements at dst + 64 * b.
+	void (*transpose_blocks)(const BITSET_BASE_TYPE* src, size_t stride, SIZE_TYPE rows, BITSET_BASE_TYPE* dst, SIZE_TYPE count);
+};
+
+extern struct bitset_kernels bitset_kernels;
+
+// Use the kernels given by type. Returns 1 on success, 0 if the CPU does not
+// support the required instruction set. In that case the kernels are not changed.
+char select_bitset_kernels(enum bitset_kernel_type type);
+
+// Name of the currently used kernels
+const char* bitset_kernels_name();
+
+// Bitsets with less base elements than this are processed inline, a call
+// through the kernel table does not pay off for them.
+#define BITSET_KERNEL_MIN_BASE_COUNT	4
+
 // Caution: The below methods do not check the index k !
 // Set bit at index k
  #define SET_BIT(bs,k)		( bs->elements[(k)/BITSET_BASE_SIZE] |= (1UL << ((k)%BITSET_BASE_SIZE)) )
@@ -66,7 +98,10 @@ void print_bitset(BitSet* bs, FILE *f);
 
 // Return 1 if bs1 is subset of bs2, otherwise 0.
 static inline char bitset_is_subset(BitSet* bs1, BitSet* bs2) {
-	int i;
+	SIZE_TYPE i;
+
+	if (bs1->base_count >= BITSET_KERNEL_MIN_BASE_COUNT)
+		return(bitset_kernels.is_subset(bs1->elements, bs2->elements, bs1->base_count));
 
 	for (i = 0; i < bs1->base_count; ++i)
 		if (bs1->elements[i] != (bs1->elements[i] & bs2->elements[i]))
@@ -75,7 +110,7 @@ static inline char bitset_is_subset(BitSet* bs1, BitSet* bs2) {
 }
 
 inline char bitset_is_equal(BitSet* bs1, BitSet* bs2) {
-	int i;
+	SIZE_TYPE i;
 
 	for (i = 0; i < bs1->base_count; ++i)
 		if (bs1->elements[i] != bs2->elements[i])
@@ -85,7 +120,12 @@ inline char bitset_is_equal(BitSet* bs1, BitSet* bs2) {
 
 // Intersect bs1 and bs2, store the result in r
 static inline void bitset_intersection(BitSet* bs1, BitSet* bs2, BitSet* r) {
-	int i;
+	SIZE_TYPE i;
+
+	if (bs1->base_count >= BITSET_KERNEL_MIN_BASE_COUNT) {
+		bitset_kernels.intersection(bs1->elements, bs2->elements, r->elements, bs1->base_count);
+		return;
+	}
 
 	for (i = 0; i < bs1->base_count; ++i)
 		r->elements[i] = bs1->elements[i] & bs2->elements[i];
@@ -94,7 +134,11 @@ static inline void bitset_intersection(BitSet* bs1, BitSet* bs2, BitSet* r) {
 // Check if intersection bs1 and bs2 is empty
 // Return 1 if yes, 0 othersie
 inline char is_bitset_intersection_empty(BitSet* bs1, BitSet* bs2) {
-	int i;
+	SIZE_TYPE i;
+
+	if (bs1->base_count >= BITSET_KERNEL_MIN_BASE_COUNT)
+		return(bitset_kernels.is_intersection_empty(bs1->elements, bs2->elements, bs1->base_count));
+
 	for (i = 0; i < bs1->base_count; ++i)
 		if ((bs1->elements[i] & bs2->elements[i]) != 0UL)
 			return(0);
@@ -102,7 +146,13 @@ inline char is_bitset_intersection_empty(BitSet* bs1, BitSet* bs2) {
 }
 // Unite bs1 and bs2, store the result in r
 inline void bitset_union(BitSet* bs1, BitSet* bs2, BitSet* r) {
-	int i;
+	SIZE_TYPE i;
+
+	if (bs1->base_count >= BITSET_KERNEL_MIN_BASE_COUNT) {
+		bitset_kernels.unite(bs1->elements, bs2->elements, r->elements, bs1->base_count);
+		return;
+	}
+
 	for (i = 0; i < bs1->base_count; ++i)
 		r->elements[i] = bs1->elements[i] | bs2->elements[i];
 }
@@ -125,7 +175,7 @@ inline void complement_bitset(BitSet* bs, BitSet* r) {
 
 // Clear all bits
 inline void reset_bitset(BitSet* bs) {
-	int i;
+	SIZE_TYPE i;
 
 	for (i = 0; i < bs->base_count; ++i)
 		bs->elements[i] = 0UL;
@@ -133,15 +183,18 @@ inline void reset_bitset(BitSet* bs) {
 
 // Compute set difference bs1 \ bs2, store it in r.
 inline void bitset_set_minus(BitSet* bs1, BitSet* bs2, BitSet* r) {
-	for (SIZE_TYPE i = 0; i < bs1->base_count; ++i) {
-		r->elements[i] = bs1->elements[i] & ~(bs2->elements[i]);
-	}
+	if (bs1->base_count >= BITSET_KERNEL_MIN_BASE_COUNT)
+		bitset_kernels.set_minus(bs1->elements, bs2->elements, r->elements, bs1->base_count);
+	else
+		for (SIZE_TYPE i = 0; i < bs1->base_count; ++i) {
+			r->elements[i] = bs1->elements[i] & ~(bs2->elements[i]);
+		}
 	r->elements[r->base_count - 1] &= get_last_full_block(r);
 }
 
 // Copy bs1 into bs2
 inline void copy_bitset(BitSet* bs1, BitSet* bs2) {
-	int i;
+	SIZE_TYPE i;
 	bs2->base_count = bs1->base_count;
 	bs2->size = bs1->size;
 	for (i = 0; i < bs1->base_count; ++i)
@@ -149,18 +202,19 @@ inline void copy_bitset(BitSet* bs1, BitSet* bs2) {
 }
 
 // Return true if all bits are set, otherwise false
-// TODO: optimize!
 inline char bitset_is_fullset(BitSet* bs) {
-	int i;
-	for (i = 0; i < bs->size; ++i)
-		if (!(TEST_BIT(bs, i)))
-			return 0;
-	return(1);
+	if (bs->base_count == 0)
+		return(1);
+	for (SIZE_TYPE i = 0; i < bs->base_count - 1; ++i)
+		if (bs->elements[i] != ~(0ULL))
+			return(0);
+	BITSET_BASE_TYPE last = get_last_full_block(bs);
+	return((bs->elements[bs->base_count - 1] & last) == last);
 }
 
 // Return true if all bits are 0, otherwise false
 inline char bitset_is_emptyset(BitSet* bs) {
-	int i;
+	SIZE_TYPE i;
 
 	for (i = 0; i < bs->base_count; ++i)
 		if (bs->elements[i] != 0UL)
@@ -168,14 +222,15 @@ inline char bitset_is_emptyset(BitSet* bs) {
 	return(1);
 }
 
+// Return the number of bits set to 1
 inline SIZE_TYPE count_bits(BitSet* bs) {
-    SIZE_TYPE count = 0;
-    for (SIZE_TYPE i = 0; i < bs->size; ++i) {
-        if (TEST_BIT(bs, i)) {
-            ++count;
-        }
-    }
-	return count;
+	SIZE_TYPE count = 0;
+
+	if (bs->base_count == 0)
+		return(0);
+	for (SIZE_TYPE i = 0; i < bs->base_count - 1; ++i)
+		count += __builtin_popcountll(bs->elements[i]);
+	return(count + __builtin_popcountll(bs->elements[bs->base_count - 1] & get_last_full_block(bs)));
 }
 
 // Set all bits
@@ -189,10 +244,159 @@ inline void set_bitset(BitSet* bs) {
 // key for hashing
 inline BITSET_BASE_TYPE get_key(BitSet* bs) {
 	BITSET_BASE_TYPE key = 0;
-	for (int i = 0; i < bs->base_count; ++i) {
+	for (SIZE_TYPE i = 0; i < bs->base_count; ++i) {
 		key ^= bs->elements[i];
 	}
 	return key;
 }
 
+// Fused operations: single pass over the operands, no temporary bitset.
+
+// Return 1 if bs1 \ bs2 contains no index smaller than k, otherwise 0.
+// (canonicity test of the closure algorithms)
+static inline char bitset_set_minus_is_empty_below(BitSet* bs1, BitSet* bs2, SIZE_TYPE k) {
+	SIZE_TYPE last = k / BITSET_BASE_SIZE;
+
+	for (SIZE_TYPE i = 0; i < last; ++i)
+		if (bs1->elements[i] & ~(bs2->elements[i]))
+			return(0);
+	if (k % BITSET_BASE_SIZE)
+		return((bs1->elements[last] & ~(bs2->elements[last]) & ((1ULL << (k % BITSET_BASE_SIZE)) - 1)) == 0);
+	return(1);
+}
+
+// Return the number of bits in bs1 \ bs2
+static inline SIZE_TYPE count_bits_set_minus(BitSet* bs1, BitSet* bs2) {
+	SIZE_TYPE count = 0;
+
+	for (SIZE_TYPE i = 0; i < bs1->base_count; ++i)
+		count += __builtin_popcountll(bs1->elements[i] & ~(bs2->elements[i]));
+	return(count);
+}
+
+// Return 1 if the intersection of bs1 and bs2 is a subset of bs3, otherwise 0.
+static inline char bitset_is_intersection_subset(BitSet* bs1, BitSet* bs2, BitSet* bs3) {
+	for (SIZE_TYPE i = 0; i < bs1->base_count; ++i)
+		if (bs1->elements[i] & bs2->elements[i] & ~(bs3->elements[i]))
+			return(0);
+	return(1);
+}
+
+// Return 1 if the intersection of bs1 and bs2 is equal to bs3, otherwise 0.
+static inline char bitset_is_intersection_equal(BitSet* bs1, BitSet* bs2, BitSet* bs3) {
+	for (SIZE_TYPE i = 0; i < bs1->base_count; ++i)
+		if ((bs1->elements[i] & bs2->elements[i]) != bs3->elements[i])
+			return(0);
+	return(1);
+}
+
+// Intersect bs1 and bs2, store the result in r.
+// Return 1 if the result is empty, otherwise 0.
+static inline char bitset_intersection_is_empty(BitSet* bs1, BitSet* bs2, BitSet* r) {
+	BITSET_BASE_TYPE any = 0;
+
+	for (SIZE_TYPE i = 0; i < bs1->base_count; ++i) {
+		r->elements[i] = bs1->elements[i] & bs2->elements[i];
+		any |= r->elements[i];
+	}
+	return(any == 0);
+}
+
+// Store bs1 \ bs2 in r. Return 1 if the result is empty, otherwise 0.
+static inline char bitset_set_minus_is_empty(BitSet* bs1, BitSet* bs2, BitSet* r) {
+	BITSET_BASE_TYPE any = 0;
+
+	for (SIZE_TYPE i = 0; i < bs1->base_count; ++i) {
+		r->elements[i] = bs1->elements[i] & ~(bs2->elements[i]);
+		any |= r->elements[i];
+	}
+	return(any == 0);
+}
+
+// Return 1 if bs1 \ bs2 and bs3 are disjoint, otherwise 0.
+// (bs1 \ bs2 is then a subset of the complement of bs3)
+static inline char bitset_is_set_minus_disjoint(BitSet* bs1, BitSet* bs2, BitSet* bs3) {
+	for (SIZE_TYPE i = 0; i < bs1->base_count; ++i)
+		if (bs1->elements[i] & ~(bs2->elements[i]) & bs3->elements[i])
+			return(0);
+	return(1);
+}
+
+// Iteration over the set bits: skip empty words, locate the bits with ctz.
+
+// Return the smallest index i >= k such that bit i is set in bs,
+// bs->size if there is no such index.
+inline SIZE_TYPE bitset_next_set_bit(BitSet* bs, SIZE_TYPE k) {
+	if (k >= bs->size)
+		return(bs->size);
+
+	SIZE_TYPE i = k / BITSET_BASE_SIZE;
+	BITSET_BASE_TYPE w = bs->elements[i] & (~(0ULL) << (k % BITSET_BASE_SIZE));
+	while (w == 0) {
+		if (++i == bs->base_count)
+			return(bs->size);
+		w = bs->elements[i];
+	}
+	k = i * BITSET_BASE_SIZE + __builtin_ctzll(w);
+	return(k < bs->size ? k : bs->size);
+}
+
+// Return the smallest index i >= k such that bit i is not set in bs,
+// bs->size if there is no such index.
+inline SIZE_TYPE bitset_next_clear_bit(BitSet* bs, SIZE_TYPE k) {
+	if (k >= bs->size)
+		return(bs->size);
+
+	SIZE_TYPE i = k / BITSET_BASE_SIZE;
+	BITSET_BASE_TYPE w = ~(bs->elements[i]) & (~(0ULL) << (k % BITSET_BASE_SIZE));
+	while (w == 0) {
+		if (++i == bs->base_count)
+			return(bs->size);
+		w = ~(bs->elements[i]);
+	}
+	k = i * BITSET_BASE_SIZE + __builtin_ctzll(w);
+	return(k < bs->size ? k : bs->size);
+}
+
+// Return the smallest index i >= k such that bit i is set in bs1 but not in bs2,
+// bs1->size if there is no such index.
+inline SIZE_TYPE bitset_next_set_minus_bit(BitSet* bs1, BitSet* bs2, SIZE_TYPE k) {
+	if (k >= bs1->size)
+		return(bs1->size);
+
+	SIZE_TYPE i = k / BITSET_BASE_SIZE;
+	BITSET_BASE_TYPE w = bs1->elements[i] & ~(bs2->elements[i]) & (~(0ULL) << (k % BITSET_BASE_SIZE));
+	while (w == 0) {
+		if (++i == bs1->base_count)
+			return(bs1->size);
+		w = bs1->elements[i] & ~(bs2->elements[i]);
+	}
+	k = i * BITSET_BASE_SIZE + __builtin_ctzll(w);
+	return(k < bs1->size ? k : bs1->size);
+}
+
+// Return the largest index i <= k such that bit i is set in bs,
+// bs->size if there is no such index.
+inline SIZE_TYPE bitset_prev_set_bit(BitSet* bs, SIZE_TYPE k) {
+	SIZE_TYPE i = k / BITSET_BASE_SIZE;
+	BITSET_BASE_TYPE w = bs->elements[i];
+
+	if (k % BITSET_BASE_SIZE != BITSET_BASE_SIZE - 1)
+		w &= (1ULL << (k % BITSET_BASE_SIZE + 1)) - 1;
+	while (w == 0) {
+		if (i-- == 0)
+			return(bs->size);
+		w = bs->elements[i];
+	}
+	return(i * BITSET_BASE_SIZE + BITSET_BASE_SIZE - 1 - __builtin_clzll(w));
+}
+
+// Loop i over the indices of the set bits of bs in increasing order, starting at k.
+// i has to be an lvalue of an unsigned type, bs must not be modified in the loop
+// body at indices larger than i.
+#define FOR_EACH_SET_BIT_FROM(bs,i,k)	for ((i) = bitset_next_set_bit((bs), (k)); (i) < (bs)->size; (i) = bitset_next_set_bit((bs), (i) + 1))
+
+// Loop i over the indices of all set bits of bs in increasing order.
+#define FOR_EACH_SET_BIT(bs,i)		FOR_EACH_SET_BIT_FROM(bs, i, 0)
+
 #endif /* BITSET_BITSET_H_ */
@@ -0,0 +1,72 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "bitset_arena.h"
+
+BitSetArena* create_bitset_arena(SIZE_TYPE bitset_size) {
+	BitSetArena* arena = (BitSetArena*) calloc(1, sizeof(BitSetArena));
+	assert(arena != NULL);
+
+	arena->bitset_size = bitset_size;
+	arena->base_count = (bitset_size + BITSET_BASE_SIZE - 1) / BITSET_BASE_SIZE;
+	// the elements follow the header, as in create_bitset
+	arena->block_size = sizeof(BitSet) + arena->base_count * sizeof(BITSET_BASE_TYPE);
+
+	return(arena);
+}
+
+int free_bitset_arena(BitSetArena* arena) {
+	int freed_bytes = 0;
+	for (SIZE_TYPE i = 0; i < arena->chunk_count; ++i) {
+		free(arena->chunks[i]);
+		freed_bytes += BITSET_ARENA_CHUNK_SIZE * arena->block_size;
+	}
+	free(arena->chunks);
+	freed_bytes += arena->chunk_count * sizeof(char*);
+	free(arena);
+	freed_bytes += sizeof(BitSetArena);
+	return(freed_bytes);
+}
+
+void grow_bitset_arena(BitSetArena* arena) {
+	char** tmp = realloc(arena->chunks, (arena->chunk_count + 1) * sizeof(char*));
+	assert(tmp != NULL);
+	arena->chunks = tmp;
+
+	char* chunk = malloc(BITSET_ARENA_CHUNK_SIZE * arena->block_size);
+	assert(chunk != NULL);
+
+	// the headers are set once, bitset_arena_alloc only clears the elements
+	for (SIZE_TYPE i = 0; i < BITSET_ARENA_CHUNK_SIZE; ++i) {
+		BitSet* bs = (BitSet*) (chunk + i * arena->block_size);
+		bs->size = arena->bitset_size;
+		bs->base_count = arena->base_count;
+		bs->elements = (BITSET_BASE_TYPE*) (bs + 1);
+	}
+
+	arena->chunks[arena->chunk_count++] = chunk;
+}
+
+extern inline BitSet* bitset_arena_at(BitSetArena* arena, size_t position);
+
+extern inline BitSet* bitset_arena_alloc(BitSetArena* arena);
+
+extern inline size_t bitset_arena_mark(BitSetArena* arena);
+
+extern inline void bitset_arena_release(BitSetArena* arena, size_t mark);
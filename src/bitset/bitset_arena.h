@@ -0,0 +1,87 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BITSET_BITSET_ARENA_H_
+#define BITSET_BITSET_ARENA_H_
+
+#include <stddef.h>
+#include <string.h>
+
+#include "bitset.h"
+
+// Arena for the temporary bitsets of a search. All bitsets of an arena have
+// the same size. They are taken from chunks in stack order: a recursion level
+// takes a mark on entry, allocates its scratch bitsets and releases them all
+// at once by going back to the mark. Chunks are only freed with the arena, so
+// after the first descent to a given depth the search does not call malloc.
+//
+// Bitsets from an arena must not be passed to free_bitset.
+
+// Number of bitsets in a chunk
+#define BITSET_ARENA_CHUNK_SIZE	64
+
+typedef struct bitset_arena BitSetArena;
+
+struct bitset_arena {
+	SIZE_TYPE bitset_size;
+	SIZE_TYPE base_count;
+	// bytes of a bitset in a chunk: header and elements
+	size_t block_size;
+	char** chunks;
+	SIZE_TYPE chunk_count;
+	// number of bitsets handed out
+	size_t top;
+};
+
+// Create an empty arena for bitsets of the given size.
+BitSetArena* create_bitset_arena(SIZE_TYPE bitset_size);
+
+// Free the arena together with all bitsets taken from it.
+// Returns the number of bytes freed
+int free_bitset_arena(BitSetArena* arena);
+
+// Add a chunk to the arena. Called by bitset_arena_alloc.
+void grow_bitset_arena(BitSetArena* arena);
+
+// The bitset handed out at the given position of the arena, a position
+// between a mark and the current position.
+inline BitSet* bitset_arena_at(BitSetArena* arena, size_t position) {
+	return((BitSet*) (arena->chunks[position / BITSET_ARENA_CHUNK_SIZE] +
+					  (position % BITSET_ARENA_CHUNK_SIZE) * arena->block_size));
+}
+
+// Return an empty bitset from the arena.
+inline BitSet* bitset_arena_alloc(BitSetArena* arena) {
+	if (arena->top == (size_t) arena->chunk_count * BITSET_ARENA_CHUNK_SIZE)
+		grow_bitset_arena(arena);
+
+	BitSet* bs = bitset_arena_at(arena, arena->top);
+	++arena->top;
+	memset(bs->elements, 0, arena->base_count * sizeof(BITSET_BASE_TYPE));
+	return(bs);
+}
+
+// Current position of the arena, to be passed to bitset_arena_release
+inline size_t bitset_arena_mark(BitSetArena* arena) {
+	return(arena->top);
+}
+
+// Give back all bitsets allocated after mark was taken.
+inline void bitset_arena_release(BitSetArena* arena, size_t mark) {
+	arena->top = mark;
+}
+
+#endif /* BITSET_BITSET_ARENA_H_ */
@@ -0,0 +1,196 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BITSET_BITSET_FIXED_WIDTH_H_
+#define BITSET_BITSET_FIXED_WIDTH_H_
+
+#include <stdbool.h>
+
+#include "bitset.h"
+
+// Bitsets of a fixed number W of base elements, for the solvers that are
+// built once per width (see af_fixed_width.h). A BitSet##W is a value: it is
+// passed and returned by copy, lives on the stack or in registers and is
+// never allocated. Its bits at and above the size of the framework are 0.
+// The loops over the W words have a constant bound and are unrolled by the
+// compiler.
+
+// Number of indices a BitSet##W can hold
+#define FIXED_WIDTH_CAPACITY(W)		((W) * BITSET_BASE_SIZE)
+
+#define FIXED_WIDTH_SET_BIT(s,k)	((s).words[(k) / BITSET_BASE_SIZE] |= 1ULL << ((k) % BITSET_BASE_SIZE))
+#define FIXED_WIDTH_RESET_BIT(s,k)	((s).words[(k) / BITSET_BASE_SIZE] &= ~(1ULL << ((k) % BITSET_BASE_SIZE)))
+#define FIXED_WIDTH_TEST_BIT(s,k)	(((s).words[(k) / BITSET_BASE_SIZE] >> ((k) % BITSET_BASE_SIZE)) & 1ULL)
+
+// Loop k over the words of a BitSet##W. -O2 does not unroll these loops on
+// its own for W = 8, which leaves the sets in memory.
+#define FOR_EACH_FIXED_WIDTH_WORD(W,k)		_Pragma("GCC unroll 8") for (SIZE_TYPE k = 0; k < (W); ++k)
+
+#define DEFINE_FIXED_WIDTH_BITSET(W)												\
+																					\
+typedef struct {																	\
+	BITSET_BASE_TYPE words[W];														\
+} BitSet##W;																		\
+																					\
+static inline BitSet##W bitset##W##_empty() {										\
+	BitSet##W r;																	\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		r.words[k] = 0ULL;															\
+	return(r);																		\
+}																					\
+																					\
+/* every bit set, for intersections masked to the size afterwards */			\
+static inline BitSet##W bitset##W##_full() {										\
+	BitSet##W r;																	\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		r.words[k] = ~(0ULL);														\
+	return(r);																		\
+}																					\
+																					\
+/* the indices 0 ... size - 1 */													\
+static inline BitSet##W bitset##W##_first(SIZE_TYPE size) {							\
+	BitSet##W r;																	\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k) {												\
+		if ((k + 1) * BITSET_BASE_SIZE <= size)										\
+			r.words[k] = ~(0ULL);													\
+		else if (k * BITSET_BASE_SIZE < size)										\
+			r.words[k] = (1ULL << (size % BITSET_BASE_SIZE)) - 1;					\
+		else																		\
+			r.words[k] = 0ULL;														\
+	}																				\
+	return(r);																		\
+}																					\
+																					\
+static inline BitSet##W bitset##W##_intersection(BitSet##W a, BitSet##W b) {		\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		a.words[k] &= b.words[k];													\
+	return(a);																		\
+}																					\
+																					\
+static inline BitSet##W bitset##W##_union(BitSet##W a, BitSet##W b) {				\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		a.words[k] |= b.words[k];													\
+	return(a);																		\
+}																					\
+																					\
+static inline BitSet##W bitset##W##_set_minus(BitSet##W a, BitSet##W b) {			\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		a.words[k] &= ~b.words[k];													\
+	return(a);																		\
+}																					\
+																					\
+static inline bool bitset##W##_is_empty(BitSet##W a) {								\
+	BITSET_BASE_TYPE any = 0ULL;													\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		any |= a.words[k];															\
+	return(any == 0ULL);															\
+}																					\
+																					\
+static inline bool bitset##W##_is_equal(BitSet##W a, BitSet##W b) {				\
+	BITSET_BASE_TYPE diff = 0ULL;													\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		diff |= a.words[k] ^ b.words[k];											\
+	return(diff == 0ULL);															\
+}																					\
+																					\
+static inline bool bitset##W##_is_subset(BitSet##W a, BitSet##W b) {				\
+	BITSET_BASE_TYPE missing = 0ULL;												\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		missing |= a.words[k] & ~b.words[k];										\
+	return(missing == 0ULL);														\
+}																					\
+																					\
+static inline bool bitset##W##_intersects(BitSet##W a, BitSet##W b) {				\
+	BITSET_BASE_TYPE common = 0ULL;													\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		common |= a.words[k] & b.words[k];											\
+	return(common != 0ULL);															\
+}																					\
+																					\
+static inline SIZE_TYPE bitset##W##_count(BitSet##W a) {							\
+	SIZE_TYPE count = 0;															\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		count += __builtin_popcountll(a.words[k]);									\
+	return(count);																	\
+}																					\
+																					\
+/* a \ b has no index below i, see bitset_set_minus_is_empty_below */				\
+static inline bool bitset##W##_set_minus_is_empty_below(BitSet##W a, BitSet##W b,	\
+		SIZE_TYPE i) {																\
+	SIZE_TYPE last = i / BITSET_BASE_SIZE;											\
+	BITSET_BASE_TYPE below = 0ULL;													\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k) {												\
+		BITSET_BASE_TYPE mask = k < last ? ~(0ULL) :								\
+			(k == last ? (1ULL << (i % BITSET_BASE_SIZE)) - 1 : 0ULL);				\
+		below |= a.words[k] & ~b.words[k] & mask;									\
+	}																				\
+	return(below == 0ULL);															\
+}																					\
+																					\
+/* the smallest index >= k in a, FIXED_WIDTH_CAPACITY(W) if there is none */		\
+static inline SIZE_TYPE bitset##W##_next(BitSet##W a, SIZE_TYPE k) {				\
+	if (k >= FIXED_WIDTH_CAPACITY(W))												\
+		return(FIXED_WIDTH_CAPACITY(W));											\
+	SIZE_TYPE i = k / BITSET_BASE_SIZE;												\
+	BITSET_BASE_TYPE w = a.words[i] & (~(0ULL) << (k % BITSET_BASE_SIZE));			\
+	while (w == 0ULL) {																\
+		if (++i == W)																\
+			return(FIXED_WIDTH_CAPACITY(W));										\
+		w = a.words[i];																\
+	}																				\
+	return(i * BITSET_BASE_SIZE + __builtin_ctzll(w));								\
+}																					\
+																					\
+/* the largest index <= k in a, FIXED_WIDTH_CAPACITY(W) if there is none */			\
+static inline SIZE_TYPE bitset##W##_prev(BitSet##W a, SIZE_TYPE k) {				\
+	SIZE_TYPE i = k / BITSET_BASE_SIZE;												\
+	BITSET_BASE_TYPE w = a.words[i];												\
+	if (k % BITSET_BASE_SIZE != BITSET_BASE_SIZE - 1)								\
+		w &= (1ULL << (k % BITSET_BASE_SIZE + 1)) - 1;								\
+	while (w == 0ULL) {																\
+		if (i-- == 0)																\
+			return(FIXED_WIDTH_CAPACITY(W));										\
+		w = a.words[i];																\
+	}																				\
+	return(i * BITSET_BASE_SIZE + BITSET_BASE_SIZE - 1 - __builtin_clzll(w));		\
+}																					\
+																					\
+/* the elements of bs, which has at most W words */									\
+static inline BitSet##W bitset##W##_load(BitSet* bs) {								\
+	BitSet##W r;																	\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		r.words[k] = k < bs->base_count ? bs->elements[k] : 0ULL;					\
+	return(r);																		\
+}																					\
+																					\
+/* copy the elements of a to bs, which has at most W words */					\
+static inline void bitset##W##_store(BitSet##W a, BitSet* bs) {					\
+	FOR_EACH_FIXED_WIDTH_WORD(W, k)												\
+		if (k < bs->base_count)														\
+			bs->elements[k] = a.words[k];											\
+}
+
+// Loop i over the elements of the BitSet##W s in increasing order
+#define FOR_EACH_FIXED_WIDTH_BIT(W,s,i)		for ((i) = bitset##W##_next((s), 0); (i) < FIXED_WIDTH_CAPACITY(W); (i) = bitset##W##_next((s), (i) + 1))
+
+// The widths the solvers are built for, frameworks of up to 64, 128, 256 and
+// 512 arguments
+DEFINE_FIXED_WIDTH_BITSET(1)
+DEFINE_FIXED_WIDTH_BITSET(2)
+DEFINE_FIXED_WIDTH_BITSET(4)
+DEFINE_FIXED_WIDTH_BITSET(8)
+
+#endif /* BITSET_BITSET_FIXED_WIDTH_H_ */
@@ -0,0 +1,426 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bitset.h"
+
+// The vectorized kernels are compiled with per-function target attributes,
+// so the rest of the code does not need to be compiled for a specific CPU.
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BITSET_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+/////////////////////////// scalar ///////////////////////////
+
+static char is_subset_scalar(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, SIZE_TYPE n) {
+	for (SIZE_TYPE i = 0; i < n; ++i)
+		if (a[i] & ~b[i])
+			return(0);
+	return(1);
+}
+
+static char is_intersection_empty_scalar(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, SIZE_TYPE n) {
+	for (SIZE_TYPE i = 0; i < n; ++i)
+		if (a[i] & b[i])
+			return(0);
+	return(1);
+}
+
+static void intersection_scalar(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n) {
+	for (SIZE_TYPE i = 0; i < n; ++i)
+		r[i] = a[i] & b[i];
+}
+
+static void unite_scalar(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n) {
+	for (SIZE_TYPE i = 0; i < n; ++i)
+		r[i] = a[i] | b[i];
+}
+
+static void set_minus_scalar(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n) {
+	for (SIZE_TYPE i = 0; i < n; ++i)
+		r[i] = a[i] & ~b[i];
+}
+
+// 64x64 bit matrix transpose with the recursive swap-mask method. In the
+// round for j the j x j blocks above the diagonal of each 2j x 2j block
+// are swapped with the ones below it, six rounds transpose the matrix.
+// Bit c of row r ends up as bit r of row c. The operations are macro
+// parameters, so that the vectorized kernels transpose several blocks at
+// once, one block per lane.
+#define TRANSPOSE_ROUND(a, j, m, AND, XOR, SRL, SLL)						\
+	for (SIZE_TYPE k = 0; k < BITSET_BASE_SIZE; k = ((k | (j)) + 1) & ~(j)) {		\
+		t = AND(XOR(SRL(a[k], j), a[k | (j)]), m);							\
+		a[k | (j)] = XOR(a[k | (j)], t);									\
+		a[k] = XOR(a[k], SLL(t, j));										\
+	}
+
+#define TRANSPOSE_ROUNDS(a, SET1, AND, XOR, SRL, SLL)									\
+	TRANSPOSE_ROUND(a, 32, SET1(0x00000000FFFFFFFFULL), AND, XOR, SRL, SLL)			\
+	TRANSPOSE_ROUND(a, 16, SET1(0x0000FFFF0000FFFFULL), AND, XOR, SRL, SLL)			\
+	TRANSPOSE_ROUND(a, 8, SET1(0x00FF00FF00FF00FFULL), AND, XOR, SRL, SLL)			\
+	TRANSPOSE_ROUND(a, 4, SET1(0x0F0F0F0F0F0F0F0FULL), AND, XOR, SRL, SLL)			\
+	TRANSPOSE_ROUND(a, 2, SET1(0x3333333333333333ULL), AND, XOR, SRL, SLL)			\
+	TRANSPOSE_ROUND(a, 1, SET1(0x5555555555555555ULL), AND, XOR, SRL, SLL)
+
+#define SCALAR_SET1(x)		(x)
+#define SCALAR_AND(x,y)		((x) & (y))
+#define SCALAR_XOR(x,y)		((x) ^ (y))
+#define SCALAR_SRL(x,j)		((x) >> (j))
+#define SCALAR_SLL(x,j)		((x) << (j))
+
+static void transpose_blocks_scalar(const BITSET_BASE_TYPE* src, size_t stride, SIZE_TYPE rows, BITSET_BASE_TYPE* dst, SIZE_TYPE count) {
+	for (SIZE_TYPE b = 0; b < count; ++b) {
+		BITSET_BASE_TYPE* a = dst + (size_t) b * BITSET_BASE_SIZE;
+		BITSET_BASE_TYPE t;
+		for (SIZE_TYPE r = 0; r < BITSET_BASE_SIZE; ++r)
+			a[r] = r < rows ? src[r * stride + b] : 0ULL;
+		TRANSPOSE_ROUNDS(a, SCALAR_SET1, SCALAR_AND, SCALAR_XOR, SCALAR_SRL, SCALAR_SLL)
+	}
+}
+
+// The vectorized transposes load row r of LANES adjacent blocks with one
+// load, transpose them lane-wise and scatter the lanes to the blocks of dst.
+#define DEFINE_TRANSPOSE_BLOCKS(NAME, VEC, LANES, ZERO, LOAD, STORE, SET1, AND, XOR, SRL, SLL)	\
+static void NAME(const BITSET_BASE_TYPE* src, size_t stride, SIZE_TYPE rows, BITSET_BASE_TYPE* dst, SIZE_TYPE count) {	\
+	SIZE_TYPE b = 0;																\
+	for (; b + LANES <= count; b += LANES) {										\
+		VEC a[BITSET_BASE_SIZE], t;													\
+		BITSET_BASE_TYPE w[BITSET_BASE_SIZE * LANES];								\
+		for (SIZE_TYPE r = 0; r < BITSET_BASE_SIZE; ++r)							\
+			a[r] = r < rows ? LOAD(src + r * stride + b) : ZERO();					\
+		TRANSPOSE_ROUNDS(a, SET1, AND, XOR, SRL, SLL)								\
+		for (SIZE_TYPE c = 0; c < BITSET_BASE_SIZE; ++c)							\
+			STORE(w + c * LANES, a[c]);												\
+		for (SIZE_TYPE l = 0; l < LANES; ++l)										\
+			for (SIZE_TYPE c = 0; c < BITSET_BASE_SIZE; ++c)						\
+				dst[(size_t) (b + l) * BITSET_BASE_SIZE + c] = w[c * LANES + l];	\
+	}																				\
+	transpose_blocks_scalar(src + b, stride, rows, dst + (size_t) b * BITSET_BASE_SIZE, count - b);	\
+}
+
+#ifdef BITSET_X86_KERNELS
+
+/////////////////////////// SSE4.1 ///////////////////////////
+// 2 base elements per iteration. ptest gives the early exit for the tests.
+
+__attribute__((target("sse4.1")))
+static char is_subset_sse4(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 2 <= n; i += 2) {
+		__m128i x = _mm_loadu_si128((const __m128i*) (a + i));
+		__m128i y = _mm_loadu_si128((const __m128i*) (b + i));
+		// testc: 1 iff x & ~y == 0
+		if (!_mm_testc_si128(y, x))
+			return(0);
+	}
+	return(is_subset_scalar(a + i, b + i, n - i));
+}
+
+__attribute__((target("sse4.1")))
+static char is_intersection_empty_sse4(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 2 <= n; i += 2) {
+		__m128i x = _mm_loadu_si128((const __m128i*) (a + i));
+		__m128i y = _mm_loadu_si128((const __m128i*) (b + i));
+		if (!_mm_testz_si128(x, y))
+			return(0);
+	}
+	return(is_intersection_empty_scalar(a + i, b + i, n - i));
+}
+
+__attribute__((target("sse4.1")))
+static void intersection_sse4(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 2 <= n; i += 2) {
+		__m128i x = _mm_loadu_si128((const __m128i*) (a + i));
+		__m128i y = _mm_loadu_si128((const __m128i*) (b + i));
+		_mm_storeu_si128((__m128i*) (r + i), _mm_and_si128(x, y));
+	}
+	intersection_scalar(a + i, b + i, r + i, n - i);
+}
+
+__attribute__((target("sse4.1")))
+static void unite_sse4(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 2 <= n; i += 2) {
+		__m128i x = _mm_loadu_si128((const __m128i*) (a + i));
+		__m128i y = _mm_loadu_si128((const __m128i*) (b + i));
+		_mm_storeu_si128((__m128i*) (r + i), _mm_or_si128(x, y));
+	}
+	unite_scalar(a + i, b + i, r + i, n - i);
+}
+
+__attribute__((target("sse4.1")))
+static void set_minus_sse4(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 2 <= n; i += 2) {
+		__m128i x = _mm_loadu_si128((const __m128i*) (a + i));
+		__m128i y = _mm_loadu_si128((const __m128i*) (b + i));
+		// andnot(y, x) = ~y & x
+		_mm_storeu_si128((__m128i*) (r + i), _mm_andnot_si128(y, x));
+	}
+	set_minus_scalar(a + i, b + i, r + i, n - i);
+}
+
+#define SSE_LOAD(p)			_mm_loadu_si128((const __m128i*) (p))
+#define SSE_STORE(p,x)		_mm_storeu_si128((__m128i*) (p), x)
+#define SSE_SET1(x)			_mm_set1_epi64x(x)
+
+__attribute__((target("sse4.1")))
+DEFINE_TRANSPOSE_BLOCKS(transpose_blocks_sse4, __m128i, 2, _mm_setzero_si128, SSE_LOAD, SSE_STORE,
+		SSE_SET1, _mm_and_si128, _mm_xor_si128, _mm_srli_epi64, _mm_slli_epi64)
+
+/////////////////////////// AVX2 ///////////////////////////
+// 4 base elements per iteration.
+
+__attribute__((target("avx2")))
+static char is_subset_avx2(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*) (a + i));
+		__m256i y = _mm256_loadu_si256((const __m256i*) (b + i));
+		if (!_mm256_testc_si256(y, x))
+			return(0);
+	}
+	return(is_subset_scalar(a + i, b + i, n - i));
+}
+
+__attribute__((target("avx2")))
+static char is_intersection_empty_avx2(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*) (a + i));
+		__m256i y = _mm256_loadu_si256((const __m256i*) (b + i));
+		if (!_mm256_testz_si256(x, y))
+			return(0);
+	}
+	return(is_intersection_empty_scalar(a + i, b + i, n - i));
+}
+
+__attribute__((target("avx2")))
+static void intersection_avx2(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*) (a + i));
+		__m256i y = _mm256_loadu_si256((const __m256i*) (b + i));
+		_mm256_storeu_si256((__m256i*) (r + i), _mm256_and_si256(x, y));
+	}
+	intersection_scalar(a + i, b + i, r + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void unite_avx2(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*) (a + i));
+		__m256i y = _mm256_loadu_si256((const __m256i*) (b + i));
+		_mm256_storeu_si256((__m256i*) (r + i), _mm256_or_si256(x, y));
+	}
+	unite_scalar(a + i, b + i, r + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void set_minus_avx2(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*) (a + i));
+		__m256i y = _mm256_loadu_si256((const __m256i*) (b + i));
+		_mm256_storeu_si256((__m256i*) (r + i), _mm256_andnot_si256(y, x));
+	}
+	set_minus_scalar(a + i, b + i, r + i, n - i);
+}
+
+#define AVX2_LOAD(p)		_mm256_loadu_si256((const __m256i*) (p))
+#define AVX2_STORE(p,x)		_mm256_storeu_si256((__m256i*) (p), x)
+#define AVX2_SET1(x)		_mm256_set1_epi64x(x)
+
+__attribute__((target("avx2")))
+DEFINE_TRANSPOSE_BLOCKS(transpose_blocks_avx2, __m256i, 4, _mm256_setzero_si256, AVX2_LOAD, AVX2_STORE,
+		AVX2_SET1, _mm256_and_si256, _mm256_xor_si256, _mm256_srli_epi64, _mm256_slli_epi64)
+
+/////////////////////////// AVX-512 ///////////////////////////
+// 8 base elements per iteration. The tail is done with masked loads and
+// stores instead of the scalar loop.
+
+#define TAIL_MASK(k)	((__mmask8) ((1U << (k)) - 1))
+
+__attribute__((target("avx512f")))
+static char is_subset_avx512(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m512i x = _mm512_loadu_si512((const void*) (a + i));
+		__m512i y = _mm512_loadu_si512((const void*) (b + i));
+		if (_mm512_test_epi64_mask(_mm512_andnot_si512(y, x), _mm512_set1_epi64(-1)))
+			return(0);
+	}
+	if (i < n) {
+		__mmask8 m = TAIL_MASK(n - i);
+		__m512i x = _mm512_maskz_loadu_epi64(m, (const void*) (a + i));
+		__m512i y = _mm512_maskz_loadu_epi64(m, (const void*) (b + i));
+		if (_mm512_test_epi64_mask(_mm512_andnot_si512(y, x), _mm512_set1_epi64(-1)))
+			return(0);
+	}
+	return(1);
+}
+
+__attribute__((target("avx512f")))
+static char is_intersection_empty_avx512(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m512i x = _mm512_loadu_si512((const void*) (a + i));
+		__m512i y = _mm512_loadu_si512((const void*) (b + i));
+		if (_mm512_test_epi64_mask(x, y))
+			return(0);
+	}
+	if (i < n) {
+		__mmask8 m = TAIL_MASK(n - i);
+		__m512i x = _mm512_maskz_loadu_epi64(m, (const void*) (a + i));
+		__m512i y = _mm512_maskz_loadu_epi64(m, (const void*) (b + i));
+		if (_mm512_test_epi64_mask(x, y))
+			return(0);
+	}
+	return(1);
+}
+
+__attribute__((target("avx512f")))
+static void intersection_avx512(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m512i x = _mm512_loadu_si512((const void*) (a + i));
+		__m512i y = _mm512_loadu_si512((const void*) (b + i));
+		_mm512_storeu_si512((void*) (r + i), _mm512_and_si512(x, y));
+	}
+	if (i < n) {
+		__mmask8 m = TAIL_MASK(n - i);
+		__m512i x = _mm512_maskz_loadu_epi64(m, (const void*) (a + i));
+		__m512i y = _mm512_maskz_loadu_epi64(m, (const void*) (b + i));
+		_mm512_mask_storeu_epi64((void*) (r + i), m, _mm512_and_si512(x, y));
+	}
+}
+
+__attribute__((target("avx512f")))
+static void unite_avx512(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m512i x = _mm512_loadu_si512((const void*) (a + i));
+		__m512i y = _mm512_loadu_si512((const void*) (b + i));
+		_mm512_storeu_si512((void*) (r + i), _mm512_or_si512(x, y));
+	}
+	if (i < n) {
+		__mmask8 m = TAIL_MASK(n - i);
+		__m512i x = _mm512_maskz_loadu_epi64(m, (const void*) (a + i));
+		__m512i y = _mm512_maskz_loadu_epi64(m, (const void*) (b + i));
+		_mm512_mask_storeu_epi64((void*) (r + i), m, _mm512_or_si512(x, y));
+	}
+}
+
+__attribute__((target("avx512f")))
+static void set_minus_avx512(const BITSET_BASE_TYPE* a, const BITSET_BASE_TYPE* b, BITSET_BASE_TYPE* r, SIZE_TYPE n) {
+	SIZE_TYPE i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m512i x = _mm512_loadu_si512((const void*) (a + i));
+		__m512i y = _mm512_loadu_si512((const void*) (b + i));
+		_mm512_storeu_si512((void*) (r + i), _mm512_andnot_si512(y, x));
+	}
+	if (i < n) {
+		__mmask8 m = TAIL_MASK(n - i);
+		__m512i x = _mm512_maskz_loadu_epi64(m, (const void*) (a + i));
+		__m512i y = _mm512_maskz_loadu_epi64(m, (const void*) (b + i));
+		_mm512_mask_storeu_epi64((void*) (r + i), m, _mm512_andnot_si512(y, x));
+	}
+}
+
+#define AVX512_LOAD(p)		_mm512_loadu_si512((const void*) (p))
+#define AVX512_STORE(p,x)	_mm512_storeu_si512((void*) (p), x)
+#define AVX512_SET1(x)		_mm512_set1_epi64(x)
+
+__attribute__((target("avx512f")))
+DEFINE_TRANSPOSE_BLOCKS(transpose_blocks_avx512, __m512i, 8, _mm512_setzero_si512, AVX512_LOAD, AVX512_STORE,
+		AVX512_SET1, _mm512_and_si512, _mm512_xor_si512, _mm512_srli_epi64, _mm512_slli_epi64)
+
+#endif /* BITSET_X86_KERNELS */
+
+/////////////////////////// dispatch ///////////////////////////
+
+struct bitset_kernels bitset_kernels = {
+	BITSET_KERNEL_SCALAR,
+	is_subset_scalar,
+	is_intersection_empty_scalar,
+	intersection_scalar,
+	unite_scalar,
+	set_minus_scalar,
+	transpose_blocks_scalar
+};
+
+char select_bitset_kernels(enum bitset_kernel_type type) {
+	struct bitset_kernels k;
+
+	switch (type) {
+	case BITSET_KERNEL_SCALAR:
+		k = (struct bitset_kernels) {type, is_subset_scalar, is_intersection_empty_scalar,
+			intersection_scalar, unite_scalar, set_minus_scalar, transpose_blocks_scalar};
+		break;
+#ifdef BITSET_X86_KERNELS
+	case BITSET_KERNEL_SSE4:
+		if (!__builtin_cpu_supports("sse4.1"))
+			return(0);
+		k = (struct bitset_kernels) {type, is_subset_sse4, is_intersection_empty_sse4,
+			intersection_sse4, unite_sse4, set_minus_sse4, transpose_blocks_sse4};
+		break;
+	case BITSET_KERNEL_AVX2:
+		if (!__builtin_cpu_supports("avx2"))
+			return(0);
+		k = (struct bitset_kernels) {type, is_subset_avx2, is_intersection_empty_avx2,
+			intersection_avx2, unite_avx2, set_minus_avx2, transpose_blocks_avx2};
+		break;
+	case BITSET_KERNEL_AVX512:
+		if (!__builtin_cpu_supports("avx512f"))
+			return(0);
+		k = (struct bitset_kernels) {type, is_subset_avx512, is_intersection_empty_avx512,
+			intersection_avx512, unite_avx512, set_minus_avx512, transpose_blocks_avx512};
+		break;
+#endif
+	default:
+		return(0);
+	}
+
+	bitset_kernels = k;
+	return(1);
+}
+
+const char* bitset_kernels_name() {
+	switch (bitset_kernels.type) {
+	case BITSET_KERNEL_SSE4:
+		return("sse4.1");
+	case BITSET_KERNEL_AVX2:
+		return("avx2");
+	case BITSET_KERNEL_AVX512:
+		return("avx512");
+	default:
+		return("scalar");
+	}
+}
+
+// Pick the widest kernels the CPU supports before main() starts.
+__attribute__((constructor))
+static void init_bitset_kernels() {
+#ifdef BITSET_X86_KERNELS
+	__builtin_cpu_init();
+#endif
+	if (!select_bitset_kernels(BITSET_KERNEL_AVX512) &&
+		!select_bitset_kernels(BITSET_KERNEL_AVX2))
+		select_bitset_kernels(BITSET_KERNEL_SSE4);
+}
@@ -0,0 +1,287 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "hybrid_set.h"
+
+// An array of more elements than this needs more space than the bitmap
+#define ARRAY_MAX_COUNT(hs)		((hs)->size / (8 * sizeof(SIZE_TYPE)))
+
+HybridSet* create_hybrid_set(SIZE_TYPE size, SIZE_TYPE capacity) {
+	HybridSet* hs = (HybridSet*) calloc(1, sizeof(HybridSet));
+	assert(hs != NULL);
+
+	hs->size = size;
+	if (capacity > ARRAY_MAX_COUNT(hs)) {
+		hs->type = HYBRID_SET_BITMAP;
+		hs->bitmap = create_bitset(size);
+	} else {
+		hs->type = HYBRID_SET_ARRAY;
+		hs->capacity = capacity;
+		if (capacity > 0) {
+			hs->indices = (SIZE_TYPE*) malloc(capacity * sizeof(SIZE_TYPE));
+			assert(hs->indices != NULL);
+		}
+	}
+
+	return(hs);
+}
+
+// Free the array, bitmap or runs of hs
+static void free_storage(HybridSet* hs) {
+	free(hs->indices);
+	if (hs->bitmap)
+		free_bitset(hs->bitmap);
+	free(hs->runs);
+	hs->indices = hs->runs = NULL;
+	hs->bitmap = NULL;
+	hs->capacity = hs->run_count = 0;
+}
+
+size_t free_hybrid_set(HybridSet* hs) {
+	size_t freed_bytes = hybrid_set_bytes(hs);
+	free_storage(hs);
+	free(hs);
+	return(freed_bytes);
+}
+
+size_t hybrid_set_bytes(HybridSet* hs) {
+	if (hs->type == HYBRID_SET_BITMAP)
+		return(sizeof(HybridSet) + sizeof(BitSet) + hs->bitmap->base_count * sizeof(BITSET_BASE_TYPE));
+	if (hs->type == HYBRID_SET_RUNS)
+		return(sizeof(HybridSet) + 2 * hs->run_count * sizeof(SIZE_TYPE));
+	return(sizeof(HybridSet) + hs->capacity * sizeof(SIZE_TYPE));
+}
+
+// Position of the first index >= k in the array
+static SIZE_TYPE lower_bound(HybridSet* hs, SIZE_TYPE k) {
+	SIZE_TYPE low = 0, high = hs->count;
+	while (low < high) {
+		SIZE_TYPE mid = low + (high - low) / 2;
+		if (hs->indices[mid] < k)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return(low);
+}
+
+// Position of the first run that ends at or after k
+static SIZE_TYPE run_lower_bound(HybridSet* hs, SIZE_TYPE k) {
+	SIZE_TYPE low = 0, high = hs->run_count;
+	while (low < high) {
+		SIZE_TYPE mid = low + (high - low) / 2;
+		if (hs->runs[2 * mid + 1] < k)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return(low);
+}
+
+// Walks over the elements of a set in increasing order, element is hs->size
+// after the last one. pos is the position in the array or the run.
+typedef struct {
+	HybridSet* hs;
+	SIZE_TYPE pos;
+	SIZE_TYPE element;
+} Cursor;
+
+static void init_cursor(Cursor* c, HybridSet* hs) {
+	c->hs = hs;
+	c->pos = 0;
+	if (hs->type == HYBRID_SET_BITMAP)
+		c->element = bitset_next_set_bit(hs->bitmap, 0);
+	else if (hs->type == HYBRID_SET_RUNS)
+		c->element = hs->run_count > 0 ? hs->runs[0] : hs->size;
+	else
+		c->element = hs->count > 0 ? hs->indices[0] : hs->size;
+}
+
+static void advance_cursor(Cursor* c) {
+	HybridSet* hs = c->hs;
+	if (hs->type == HYBRID_SET_BITMAP) {
+		c->element = bitset_next_set_bit(hs->bitmap, c->element + 1);
+	} else if (hs->type == HYBRID_SET_RUNS) {
+		if (c->element < hs->runs[2 * c->pos + 1])
+			++c->element;
+		else
+			c->element = ++c->pos < hs->run_count ? hs->runs[2 * c->pos] : hs->size;
+	} else {
+		c->element = ++c->pos < hs->count ? hs->indices[c->pos] : hs->size;
+	}
+}
+
+// Replace the elements of hs by the count indices in increasing order, space
+// for capacity of them. hs takes indices over.
+static void store_array(HybridSet* hs, SIZE_TYPE* indices, SIZE_TYPE count, SIZE_TYPE capacity) {
+	free_storage(hs);
+	hs->type = HYBRID_SET_ARRAY;
+	hs->indices = indices;
+	hs->count = count;
+	hs->capacity = capacity;
+}
+
+static void convert_to_bitmap(HybridSet* hs) {
+	BitSet* bitmap = create_bitset(hs->size);
+	hybrid_set_union_into(hs, bitmap);
+	SIZE_TYPE count = hs->count;
+	free_storage(hs);
+	hs->bitmap = bitmap;
+	hs->count = count;
+	hs->type = HYBRID_SET_BITMAP;
+}
+
+// Store the runs of hs as an array or a bitmap, so that elements can be added
+static void expand_runs(HybridSet* hs) {
+	if (hs->count > ARRAY_MAX_COUNT(hs)) {
+		convert_to_bitmap(hs);
+		return;
+	}
+	SIZE_TYPE* indices = (SIZE_TYPE*) malloc((hs->count > 0 ? hs->count : 1) * sizeof(SIZE_TYPE));
+	assert(indices != NULL);
+	Cursor c;
+	SIZE_TYPE k = 0;
+	for (init_cursor(&c, hs); c.element < hs->size; advance_cursor(&c))
+		indices[k++] = c.element;
+	store_array(hs, indices, k, k);
+}
+
+void hybrid_set_add(HybridSet* hs, SIZE_TYPE k) {
+	if (hs->type == HYBRID_SET_RUNS) {
+		if (hybrid_set_contains(hs, k))
+			return;
+		expand_runs(hs);
+	}
+
+	if (hs->type == HYBRID_SET_BITMAP) {
+		if (!TEST_BIT(hs->bitmap, k)) {
+			SET_BIT(hs->bitmap, k);
+			++hs->count;
+		}
+		return;
+	}
+
+	// the indices usually come in increasing order, check the end first
+	SIZE_TYPE pos = (hs->count == 0 || hs->indices[hs->count - 1] < k) ? hs->count : lower_bound(hs, k);
+	if (pos < hs->count && hs->indices[pos] == k)
+		return;
+
+	if (hs->count == ARRAY_MAX_COUNT(hs)) {
+		convert_to_bitmap(hs);
+		SET_BIT(hs->bitmap, k);
+		++hs->count;
+		return;
+	}
+
+	if (hs->count == hs->capacity) {
+		hs->capacity = hs->capacity ? 2 * hs->capacity : 4;
+		if (hs->capacity > ARRAY_MAX_COUNT(hs))
+			hs->capacity = ARRAY_MAX_COUNT(hs);
+		SIZE_TYPE* tmp = realloc(hs->indices, hs->capacity * sizeof(SIZE_TYPE));
+		assert(tmp != NULL);
+		hs->indices = tmp;
+	}
+	memmove(hs->indices + pos + 1, hs->indices + pos, (hs->count - pos) * sizeof(SIZE_TYPE));
+	hs->indices[pos] = k;
+	++hs->count;
+}
+
+char hybrid_set_contains(HybridSet* hs, SIZE_TYPE k) {
+	if (hs->type == HYBRID_SET_BITMAP)
+		return(TEST_BIT(hs->bitmap, k) != 0);
+
+	if (hs->type == HYBRID_SET_RUNS) {
+		SIZE_TYPE run = run_lower_bound(hs, k);
+		return(run < hs->run_count && hs->runs[2 * run] <= k);
+	}
+
+	SIZE_TYPE pos = lower_bound(hs, k);
+	return(pos < hs->count && hs->indices[pos] == k);
+}
+
+SIZE_TYPE hybrid_set_next(HybridSet* hs, SIZE_TYPE k) {
+	if (hs->type == HYBRID_SET_BITMAP)
+		return(bitset_next_set_bit(hs->bitmap, k));
+
+	if (hs->type == HYBRID_SET_RUNS) {
+		SIZE_TYPE run = run_lower_bound(hs, k);
+		if (run == hs->run_count)
+			return(hs->size);
+		return(hs->runs[2 * run] > k ? hs->runs[2 * run] : k);
+	}
+
+	SIZE_TYPE pos = lower_bound(hs, k);
+	return(pos < hs->count ? hs->indices[pos] : hs->size);
+}
+
+void hybrid_set_union_into(HybridSet* hs, BitSet* r) {
+	if (hs->type == HYBRID_SET_BITMAP) {
+		bitset_union(r, hs->bitmap, r);
+		return;
+	}
+	if (hs->type == HYBRID_SET_RUNS) {
+		for (SIZE_TYPE k = 0; k < hs->run_count; ++k) {
+			SIZE_TYPE i = hs->runs[2 * k], last = hs->runs[2 * k + 1];
+			// the bits up to the first word boundary, whole words, the rest
+			for (; i <= last && i % BITSET_BASE_SIZE; ++i)
+				SET_BIT(r, i);
+			for (; i + BITSET_BASE_SIZE - 1 <= last; i += BITSET_BASE_SIZE)
+				r->elements[i / BITSET_BASE_SIZE] = ~(BITSET_BASE_TYPE) 0;
+			for (; i <= last; ++i)
+				SET_BIT(r, i);
+		}
+		return;
+	}
+	for (SIZE_TYPE i = 0; i < hs->count; ++i)
+		SET_BIT(r, hs->indices[i]);
+}
+
+void hybrid_set_optimize(HybridSet* hs) {
+	if (hs->type == HYBRID_SET_RUNS || hs->count == 0)
+		return;
+
+	SIZE_TYPE run_count = 0, previous = 0;
+	Cursor c;
+	for (init_cursor(&c, hs); c.element < hs->size; advance_cursor(&c)) {
+		if (run_count == 0 || c.element != previous + 1)
+			++run_count;
+		previous = c.element;
+	}
+	if (sizeof(HybridSet) + 2 * run_count * sizeof(SIZE_TYPE) >= hybrid_set_bytes(hs))
+		return;
+
+	SIZE_TYPE* runs = (SIZE_TYPE*) malloc(2 * run_count * sizeof(SIZE_TYPE));
+	assert(runs != NULL);
+	SIZE_TYPE k = 0;
+	for (init_cursor(&c, hs); c.element < hs->size; advance_cursor(&c)) {
+		if (k == 0 || c.element != runs[2 * k - 1] + 1) {
+			runs[2 * k] = c.element;
+			++k;
+		}
+		runs[2 * k - 1] = c.element;
+	}
+	SIZE_TYPE count = hs->count;
+	free_storage(hs);
+	hs->type = HYBRID_SET_RUNS;
+	hs->runs = runs;
+	hs->run_count = run_count;
+	hs->count = count;
+}
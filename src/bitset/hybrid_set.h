@@ -0,0 +1,77 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef BITSET_HYBRID_SET_H_
+#define BITSET_HYBRID_SET_H_
+
+#include "bitset.h"
+
+// A set of indices smaller than size. While the set is sparse it is stored
+// as a sorted array of indices, once the array would need more space than a
+// bitmap it is converted to a BitSet. hybrid_set_optimize stores a set as
+// runs of consecutive indices if they take less space than both. This is the
+// container selection of roaring bitmaps, done per set instead of per block
+// of 2^16 indices: the rows of the frameworks are either tiny or dense.
+enum hybrid_set_type {HYBRID_SET_ARRAY, HYBRID_SET_BITMAP, HYBRID_SET_RUNS};
+
+typedef struct hybrid_set HybridSet;
+
+struct hybrid_set {
+	enum hybrid_set_type type;
+	SIZE_TYPE size;
+	// number of elements
+	SIZE_TYPE count;
+	// HYBRID_SET_ARRAY: sorted indices, space for capacity of them
+	SIZE_TYPE* indices;
+	SIZE_TYPE capacity;
+	// HYBRID_SET_BITMAP
+	BitSet* bitmap;
+	// HYBRID_SET_RUNS: run k is runs[2k] ... runs[2k + 1], both included, in
+	// increasing order and not adjacent
+	SIZE_TYPE* runs;
+	SIZE_TYPE run_count;
+};
+
+// Create an empty set of the given size with space for capacity indices.
+HybridSet* create_hybrid_set(SIZE_TYPE size, SIZE_TYPE capacity);
+
+// Free the set. Returns the number of bytes freed
+size_t free_hybrid_set(HybridSet* hs);
+
+// Add index k to the set
+void hybrid_set_add(HybridSet* hs, SIZE_TYPE k);
+
+// Return 1 if index k is in the set, otherwise 0
+char hybrid_set_contains(HybridSet* hs, SIZE_TYPE k);
+
+// Return the smallest element >= k, hs->size if there is none
+SIZE_TYPE hybrid_set_next(HybridSet* hs, SIZE_TYPE k);
+
+// Add the elements of hs to the bitset r
+void hybrid_set_union_into(HybridSet* hs, BitSet* r);
+
+// Store hs as runs if they need less space than its array or bitmap. Adding
+// an element to a set of runs stores it as an array or bitmap again.
+void hybrid_set_optimize(HybridSet* hs);
+
+// Bytes used by the set
+size_t hybrid_set_bytes(HybridSet* hs);
+
+// Loop i over the elements of hs in increasing order
+#define FOR_EACH_HYBRID_SET_ELEMENT(hs,i)	for ((i) = hybrid_set_next((hs), 0); (i) < (hs)->size; (i) = hybrid_set_next((hs), (i) + 1))
+
+#endif /* BITSET_HYBRID_SET_H_ */
@@ -22,15 +22,28 @@
 
 #include "../bitset/bitset.h"
 #include "../af/af.h"
+#include "af_parser.h"
 
 AF* read_af(FILE* input_fd) {
+	return(read_af_with_budget(input_fd, 0));
+}
+
+AF* read_af_with_budget(FILE* input_fd, size_t memory_budget) {
 	SIZE_TYPE arg_count = 0;
 	long unsigned int att_count = 0;
 
 	int rc = fscanf(input_fd, "p af %d", &arg_count);
 
-	// create an AF with size arg_count
-	AF *af = create_argumentation_framework(arg_count);
+	// the weakly connected components are joined attack by attack
+	SIZE_TYPE* parent = (SIZE_TYPE*) malloc((arg_count > 0 ? arg_count : 1) * sizeof(SIZE_TYPE));
+	assert(parent != NULL);
+	for (SIZE_TYPE i = 0; i < arg_count; ++i)
+		parent[i] = i;
+
+	// read the attacks first, the storage is chosen from their number
+	long unsigned int att_capacity = 1024;
+	SIZE_TYPE* attacks = (SIZE_TYPE*) malloc(2 * att_capacity * sizeof(SIZE_TYPE));
+	assert(attacks != NULL);
 
 	int arg1, arg2;
 	do {
@@ -40,15 +53,47 @@ AF* read_af(FILE* input_fd) {
 			// skip until end-of-line
 			fscanf(input_fd, "%*[^\n]\n");
 		else {
+			if (att_count == att_capacity) {
+				att_capacity *= 2;
+				SIZE_TYPE* tmp = realloc(attacks, 2 * att_capacity * sizeof(SIZE_TYPE));
+				assert(tmp != NULL);
+				attacks = tmp;
+			}
+			attacks[2 * att_count] = arg1 - 1;
+			attacks[2 * att_count + 1] = arg2 - 1;
 			++att_count;
-			ADD_ATTACK(af, arg1, arg2);
+			union_arguments(parent, arg1 - 1, arg2 - 1);
 		}
 	} while (rc != EOF);
 
+	AF *af;
+	if (plan_af_storage(arg_count, att_count, memory_budget) == AF_STORAGE_DENSE) {
+		// create an AF with size arg_count
+		af = create_argumentation_framework(arg_count);
+		for (long unsigned int i = 0; i < att_count; ++i)
+			ADD_ATTACK(af, attacks[2 * i] + 1, attacks[2 * i + 1] + 1);
+	} else {
+		SIZE_TYPE* victim_counts = (SIZE_TYPE*) calloc(arg_count > 0 ? arg_count : 1, sizeof(SIZE_TYPE));
+		assert(victim_counts != NULL);
+		for (long unsigned int i = 0; i < att_count; ++i)
+			++victim_counts[attacks[2 * i]];
+		af = create_sparse_argumentation_framework(arg_count, victim_counts);
+		for (long unsigned int i = 0; i < att_count; ++i)
+			hybrid_set_add(af->sparse_graph[attacks[2 * i]], attacks[2 * i + 1]);
+		for (SIZE_TYPE i = 0; i < arg_count; ++i)
+			hybrid_set_optimize(af->sparse_graph[i]);
+		free(victim_counts);
+	}
+	set_adjacency_lists(af, attacks, att_count);
+	free(attacks);
+	set_weak_components(af, parent);
+
 	printf("Argument count: %d\n", arg_count);
 	printf("Attacks count : %lu\n", att_count);
-	printf("Density : %lf\n", ((double) att_count) / (arg_count * arg_count));
+	printf("Density : %lf\n", ((double) att_count) / ((double) arg_count * arg_count));
+	if (IS_SPARSE_AF(af))
+		printf("Storage : sparse (%.1f MB instead of %.1f MB dense)\n",
+			   sparse_af_bytes(arg_count, att_count) / 1048576.0, dense_af_bytes(arg_count, att_count) / 1048576.0);
 
 	return(af);
 }
-
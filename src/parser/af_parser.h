@@ -23,4 +23,9 @@
 // Read the argumentation framework from file into AF.
 AF* read_af(FILE* af);
 
+// Read the argumentation framework from file into AF. The framework is stored
+// sparse if the dense matrices would not fit in memory_budget bytes
+// (0: no limit, always dense).
+AF* read_af_with_budget(FILE* af, size_t memory_budget);
+
 #endif /* PARSER_AF_PARSER_H_ */
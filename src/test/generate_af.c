@@ -0,0 +1,38 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "../parser/af_parser.h"
+#include "generate_af.h"
+
+AF* generate_framework(SIZE_TYPE size, int density, AttackChance attack_chance) {
+	FILE* fd = tmpfile();
+	assert(fd != NULL);
+	fprintf(fd, "p af %u\n", size);
+	for (SIZE_TYPE i = 0; i < size; ++i)
+		for (SIZE_TYPE j = 0; j < size; ++j) {
+			int chance = attack_chance ? attack_chance(size, i, j, density) : density;
+			if (chance >= 100 || (chance > 0 && rand() % 100 < chance))
+				fprintf(fd, "%u %u\n", i + 1, j + 1);
+		}
+	rewind(fd);
+	AF* af = read_af(fd);
+	fclose(fd);
+	return(af);
+}
@@ -0,0 +1,31 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TEST_GENERATE_AF_H_
+#define TEST_GENERATE_AF_H_
+
+#include "../af/af.h"
+
+// Percent chance that argument i attacks argument j (both from 0) in a
+// generated framework of size arguments with the given density
+typedef int (*AttackChance)(SIZE_TYPE size, SIZE_TYPE i, SIZE_TYPE j, int density);
+
+// A framework on size arguments, written to a temporary file and read back
+// with the parser. i attacks j with attack_chance(size, i, j, density)
+// percent, or density percent if attack_chance is NULL.
+AF* generate_framework(SIZE_TYPE size, int density, AttackChance attack_chance);
+
+#endif /* TEST_GENERATE_AF_H_ */
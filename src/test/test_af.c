@@ -20,6 +20,246 @@
 
 #include "../parser/af_parser.h"
 #include "../af/af.h"
+#include "../af/af_fixed_width.h"
+#include "../algorithms/cbo/preferred.h"
+#include "../algorithms/fcbo/fcbo.h"
+#include "../algorithms/next-closure/stable.h"
+#include "../algorithms/next-closure/preferred.h"
+#include "../algorithms/next-closure/complete.h"
+#include "../algorithms/next-closure/next_closure.h"
+#include "../algorithms/connected-components/scc.h"
+#include "generate_af.h"
+
+// the two lists hold the same sets, each once
+bool is_same_extension_list(ListNode* a, ListNode* b) {
+	SIZE_TYPE count_a = 0, count_b = 0;
+	for (ListNode* node = b; node; node = node->next)
+		++count_b;
+	for (; a; a = a->next) {
+		ListNode* node = b;
+		while (node && !bitset_is_equal(a->c, node->c))
+			node = node->next;
+		if (!node)
+			return(false);
+		++count_a;
+	}
+	return(count_a == count_b);
+}
+
+bool list_contains(ListNode* node, BitSet* bs) {
+	for (; node; node = node->next)
+		if (bitset_is_equal(node->c, bs))
+			return(true);
+	return(false);
+}
+
+// Compare the operators with their reference computations on random subsets
+// of the arguments of af: the closure operators with a bit by bit
+// computation, the complemented operators with the operators on the
+// complement, the column-indexed operators and queries with the row scans,
+// and the batched closures on the lists and on the rows with the closures of
+// the candidates one at a time.
+void check_operators(AF* af, int rounds) {
+	AF* af_c = complement_argumentation_framework(af);
+	AF* attacked_by = transpose_argumentation_framework(af);
+	AF* rows_only = complement_argumentation_framework(af_c);
+	AF* rows_only_t = transpose_argumentation_framework(rows_only);
+	AF* batch_frameworks[][2] = {{af, attacked_by}, {rows_only, rows_only_t}};
+	ClosureBatch* batch = create_closure_batch(af->size);
+	BitSet* bs = create_bitset(af->size);
+	BitSet* r = create_bitset(af->size);
+	BitSet* expected = create_bitset(af->size);
+	BitSet* down = create_bitset(af->size);
+
+	for (int k = 0; k < rounds; ++k) {
+		reset_bitset(bs);
+		for (SIZE_TYPE i = 0; i < af->size; ++i)
+			if (rand() % (k % 8 + 2) == 0)
+				SET_BIT(bs, i);
+
+		down_arrow(af, bs, down);
+		up_arrow(af, bs, r);
+		for (SIZE_TYPE i = 0; i < af->size; ++i) {
+			char attacks_all = 1, attacked_by_all = 1;
+			for (SIZE_TYPE j = 0; j < af->size; ++j)
+				if (TEST_BIT(bs, j)) {
+					attacks_all &= CHECK_ARG_ATTACKS_ARG(af, i, j) != 0;
+					attacked_by_all &= CHECK_ARG_ATTACKS_ARG(af, j, i) != 0;
+				}
+			assert(!TEST_BIT(down, i) == !attacks_all);
+			assert(!TEST_BIT(r, i) == !attacked_by_all);
+		}
+		down_up_arrow(af, bs, r);
+		up_arrow(af, down, expected);
+		assert(bitset_is_equal(r, expected));
+
+		complement_up_arrow(af, bs, r);
+		up_arrow(af_c, bs, expected);
+		assert(bitset_is_equal(r, expected));
+		complement_down_arrow(af, bs, r);
+		down_arrow(af_c, bs, expected);
+		assert(bitset_is_equal(r, expected));
+		complement_down_up_arrow(af, bs, r);
+		down_up_arrow(af_c, bs, expected);
+		assert(bitset_is_equal(r, expected));
+
+		down_arrow(af, bs, expected);
+		down_arrow_by_columns(attacked_by, bs, r);
+		assert(bitset_is_equal(r, expected));
+		down_up_arrow(af, bs, expected);
+		down_up_arrow_by_columns(af, attacked_by, bs, down, r);
+		assert(bitset_is_equal(r, expected));
+		complement_down_arrow(af, bs, expected);
+		complement_down_arrow_by_columns(attacked_by, bs, r);
+		assert(bitset_is_equal(r, expected));
+		complement_down_up_arrow(af, bs, expected);
+		complement_down_up_arrow_by_columns(af, attacked_by, bs, down, r);
+		assert(bitset_is_equal(r, expected));
+		for (SIZE_TYPE i = 0; i < af->size; ++i) {
+			assert(check_set_attacks_arg_by_columns(attacked_by, bs, i) == check_set_attacks_arg(af, bs, i));
+			assert(check_set_defends_arg_by_columns(attacked_by, bs, i) == check_set_defends_arg(af, bs, i));
+		}
+
+		// the candidates start anywhere, so that they fall into every word
+		AF* a = batch_frameworks[k % 2][0];
+		AF* a_t = batch_frameworks[k % 2][1];
+		batch->count = 0;
+		for (SIZE_TYPE i = rand() % af->size; i < af->size && batch->count < BITSET_BASE_SIZE; ++i)
+			if (!TEST_BIT(bs, i))
+				batch->candidates[batch->count++] = i;
+		if (batch->count == 0)
+			continue;
+		complement_down_up_arrow_batch(a, a_t, bs, batch);
+		BITSET_BASE_TYPE canonical = canonical_batch_closures(batch, bs);
+		for (SIZE_TYPE b = 0; b < batch->count; ++b) {
+			SIZE_TYPE c = batch->candidates[b];
+			SET_BIT(bs, c);
+			complement_down_up_arrow(a, bs, expected);
+			RESET_BIT(bs, c);
+			get_batch_closure(batch, b, r);
+			assert(bitset_is_equal(r, expected));
+			assert(!(canonical >> b & 1) == !bitset_set_minus_is_empty_below(expected, bs, c));
+		}
+	}
+	printf("operators on %u arguments: OK\n", af->size);
+
+	free_bitset(bs);
+	free_bitset(r);
+	free_bitset(expected);
+	free_bitset(down);
+	free_closure_batch(batch);
+	free_argumentation_framework(rows_only_t);
+	free_argumentation_framework(rows_only);
+	free_argumentation_framework(attacked_by);
+	free_argumentation_framework(af_c);
+}
+
+// The arguments divisible by three attack each other, each other argument
+// attacks the next one, and density percent of the pairs are added as attacks.
+int cliques_and_chains(SIZE_TYPE size, SIZE_TYPE i, SIZE_TYPE j, int density) {
+	if ((i != j && i % 3 == 0 && j % 3 == 0) || (i % 3 == 1 && j == i + 1))
+		return(100);
+	return(density);
+}
+
+// Blocks of five arguments, each attacking the next one and the last one
+// attacking the first, and density percent of the pairs added as attacks.
+int cycles(SIZE_TYPE size, SIZE_TYPE i, SIZE_TYPE j, int density) {
+	if ((j == i + 1 && j % 5 != 0) || (i % 5 == 4 && j == i - 4))
+		return(100);
+	return(density);
+}
+
+// A ring, each argument attacking the next one, and density percent of the
+// pairs added as attacks.
+int ring(SIZE_TYPE size, SIZE_TYPE i, SIZE_TYPE j, int density) {
+	if (j == (i + 1) % size)
+		return(100);
+	return(density);
+}
+
+// Set reached to the arguments in within that i reaches with the attacks of
+// af, i included.
+void reach(AF* af, SIZE_TYPE i, BitSet* within, BitSet* reached) {
+	BitSet* next = create_bitset(af->size);
+	SIZE_TYPE count;
+	reset_bitset(reached);
+	SET_BIT(reached, i);
+	do {
+		count = count_bits(reached);
+		get_victims(af, reached, next);
+		bitset_intersection(next, within, next);
+		bitset_union(reached, next, reached);
+	} while (count_bits(reached) != count);
+	free_bitset(next);
+}
+
+// The condensation of the subframework of af on arguments: its components
+// partition the arguments, each of them is strongly connected and every
+// attack between two of them goes to the later one. af_t is the transpose
+// of af.
+void check_condensation(AF* af, AF* af_t, BitSet* arguments) {
+	Condensation* condensation = compute_condensation(af, arguments);
+	BitSet* component = create_bitset(af->size);
+	BitSet* reached = create_bitset(af->size);
+	SIZE_TYPE total = 0;
+	for (SIZE_TYPE k = 0; k < condensation->count; ++k) {
+		reset_bitset(component);
+		get_component_mask(condensation, k, component);
+		SIZE_TYPE size = condensation->offsets[k + 1] - condensation->offsets[k];
+		assert(size > 0 && count_bits(component) == size);
+		assert(bitset_is_subset(component, arguments));
+		for (SIZE_TYPE m = condensation->offsets[k]; m < condensation->offsets[k + 1]; ++m) {
+			assert(condensation->component_of[condensation->members[m]] == k);
+			assert(m == condensation->offsets[k] || condensation->members[m] > condensation->members[m - 1]);
+		}
+		total += size;
+		SIZE_TYPE first = condensation->members[condensation->offsets[k]];
+		reach(af, first, component, reached);
+		assert(bitset_is_equal(reached, component));
+		reach(af_t, first, component, reached);
+		assert(bitset_is_equal(reached, component));
+	}
+	assert(total == count_bits(arguments));
+	for (SIZE_TYPE i = 0; i < af->size; ++i) {
+		if (!TEST_BIT(arguments, i)) {
+			assert(condensation->component_of[i] == af->size);
+			continue;
+		}
+		SIZE_TYPE j;
+		FOR_EACH_SET_BIT(af->graph[i], j)
+			assert(!TEST_BIT(arguments, j) || condensation->component_of[i] <= condensation->component_of[j]);
+	}
+	free_bitset(reached);
+	free_bitset(component);
+	free_condensation(condensation);
+}
+
+// The preferred extensions found by the plain CbO search, which closes its
+// candidates in batches and keeps a few children of a node at a time. The
+// search is suspended after every budget nodes and resumed, it runs without
+// a stop if budget is 0.
+ListNode* ee_pr_plain_cbo(AF* af, size_t budget) {
+	BitSet* c = create_bitset(af->size);
+	set_bitset(c);
+	for (SIZE_TYPE i = 0; i < af->size; ++i)
+		bitset_set_minus(c, af->graph[i], c);
+	ListNode* extensions = NULL;
+	CbOSearch* search = create_cbo_search(af, c, NULL);
+	enum cbo_status status;
+	while ((status = run_cbo_search(search, budget)) != CBO_EXHAUSTED) {
+		if (status == CBO_SUSPENDED)
+			continue;
+		BitSet* candidate = create_bitset(af->size);
+		copy_bitset(search->extension, candidate);
+		extensions = add_candidate(extensions, candidate);
+		if (extensions->c != candidate)
+			free_bitset(candidate);
+	}
+	free_cbo_search(search);
+	free_bitset(c);
+	return(extensions);
+}
 
 int main(int argc, char *argv[]) {
 
@@ -47,6 +287,328 @@ int main(int argc, char *argv[]) {
 	print_bitset(r, stdout);
 	printf("\n");
 
+	// the adjacency lists of the parser, the transpose and a projection
+	// agree with the matrices
+	AF* af_t = transpose_argumentation_framework(af);
+	reset_bitset(bs);
+	for (SIZE_TYPE i = 0; i < af->size; i += 2)
+		SET_BIT(bs, i);
+	PAF* paf = project_argumentation_framework(af, bs);
+	AF* frameworks[] = {af, af_t, paf->af};
+	for (int f = 0; f < 3; ++f) {
+		AF* a = frameworks[f];
+		assert(HAS_ADJACENCY_LISTS(a));
+		for (SIZE_TYPE i = 0; i < a->size; ++i) {
+			SIZE_TYPE j, n = 0, last = 0;
+			FOR_EACH_VICTIM(a, i, j) {
+				assert(CHECK_ARG_ATTACKS_ARG(a, i, j));
+				assert(n == 0 || j > last);
+				last = j;
+				++n;
+			}
+			assert(n == count_bits(a->graph[i]));
+			n = 0;
+			FOR_EACH_ATTACKER(a, i, j) {
+				assert(CHECK_ARG_ATTACKS_ARG(a, j, i));
+				++n;
+			}
+			for (SIZE_TYPE k = 0; k < a->size; ++k)
+				n -= CHECK_ARG_ATTACKS_ARG(a, k, i) != 0;
+			assert(n == 0);
+		}
+	}
+	printf("adjacency lists: OK\n");
+
+	// a view restricted twice and copied: the attacks of af among the
+	// arguments in both masks, a loop on the arguments in the loop mask of the
+	// outer view, and the indices of af back from the copy
+	AF* viewed = generate_framework(100, 10, NULL);
+	BitSet* outer = create_bitset(viewed->size);
+	BitSet* inner = create_bitset(viewed->size);
+	BitSet* loops = create_bitset(viewed->size);
+	for (SIZE_TYPE i = 0; i < viewed->size; ++i) {
+		if (i % 2 == 0)
+			SET_BIT(outer, i);
+		if (i % 3 != 0)
+			SET_BIT(inner, i);
+		if (i % 5 == 0)
+			SET_BIT(loops, i);
+	}
+	PAFView* root_view = create_paf_view(viewed);
+	PAFView* view = restrict_paf_view(root_view, outer, loops);
+	PAFView* nested_view = restrict_paf_view(view, inner, NULL);
+	PAF* projected = project_paf_view(nested_view, outer);
+	SIZE_TYPE k = 0;
+	for (SIZE_TYPE i = 0; i < viewed->size; ++i) {
+		if (i % 2 != 0 || i % 3 == 0)
+			continue;
+		assert(projected->base_mapping[k] == i);
+		SIZE_TYPE l = 0;
+		for (SIZE_TYPE j = 0; j < viewed->size; ++j) {
+			if (j % 2 != 0 || j % 3 == 0)
+				continue;
+			assert(!CHECK_ARG_ATTACKS_ARG(projected->af, k, l) ==
+					!(CHECK_ARG_ATTACKS_ARG(viewed, i, j) || (i == j && i % 5 == 0)));
+			++l;
+		}
+		++k;
+	}
+	assert(k == nested_view->size && k == projected->af->size);
+	BitSet* projected_all = create_bitset(projected->af->size);
+	set_bitset(projected_all);
+	BitSet* back = project_back(projected_all, projected);
+	assert(bitset_is_equal(back, nested_view->arguments));
+	// every argument of the view on the loop mask attacks itself
+	assert(restrict_paf_view(view, loops, NULL) == NULL);
+	free_bitset(back);
+	free_bitset(projected_all);
+	free_projected_argumentation_framework(projected);
+	free_paf_view(nested_view);
+	free_paf_view(view);
+	free_paf_view(root_view);
+	free_bitset(outer);
+	free_bitset(inner);
+	free_bitset(loops);
+	free_argumentation_framework(viewed);
+	printf("framework views: OK\n");
+
+	// the condensations of generated and cyclic frameworks, with and without
+	// adjacency lists, on all arguments and on every other argument
+	AttackChance chances[] = {NULL, cycles};
+	int densities[] = {0, 2, 10, 30};
+	for (int c = 0; c < 2; ++c)
+		for (int d = 0; d < 4; ++d) {
+			AF* condensed = generate_framework(120, densities[d], chances[c]);
+			AF* condensed_t = transpose_argumentation_framework(condensed);
+			BitSet* arguments = create_bitset(condensed->size);
+			set_bitset(arguments);
+			AF* condensed_c = complement_argumentation_framework(condensed);
+			AF* rows_only = complement_argumentation_framework(condensed_c);
+			assert(!HAS_ADJACENCY_LISTS(rows_only));
+			check_condensation(condensed, condensed_t, arguments);
+			check_condensation(rows_only, condensed_t, arguments);
+			for (SIZE_TYPE i = 0; i < condensed->size; i += 2)
+				RESET_BIT(arguments, i);
+			check_condensation(condensed, condensed_t, arguments);
+			check_condensation(rows_only, condensed_t, arguments);
+			free_bitset(arguments);
+			free_argumentation_framework(rows_only);
+			free_argumentation_framework(condensed_c);
+			free_argumentation_framework(condensed_t);
+			free_argumentation_framework(condensed);
+		}
+	printf("condensations: OK\n");
+
+	// the splits of a ring cached in its condensation: for each of twenty
+	// sets of remaining arguments, repeated ten times, the cached source
+	// component is the one of a fresh condensation of the same arguments,
+	// and the repeats find it in the cache
+	AF* split = generate_framework(90, 3, ring);
+	BitSet* remaining = create_bitset(split->size);
+	BitSet* cached = create_bitset(split->size);
+	BitSet* fresh = create_bitset(split->size);
+	set_bitset(remaining);
+	Condensation* condensation = compute_condensation(split, remaining);
+	assert(condensation->count == 1);
+	for (int round = 0; round < 200; ++round) {
+		set_bitset(remaining);
+		for (SIZE_TYPE i = 0; i < split->size; ++i)
+			if ((i * 7 + round % 20) % 23 == 0)
+				RESET_BIT(remaining, i);
+		SIZE_TYPE first = 0;
+		SIZE_TYPE entries = condensation->splits ? condensation->splits->element_count : 0;
+		find_remaining_source_component(split, condensation, &first, remaining, cached);
+		assert(first == 0);
+		assert(condensation->splits->element_count == entries + (round < 20));
+		reset_bitset(fresh);
+		find_source_component(split, remaining, fresh);
+		assert(bitset_is_equal(cached, fresh));
+		// a strongly connected component without attackers in remaining
+		SIZE_TYPE i;
+		FOR_EACH_SET_BIT(cached, i) {
+			reach(split, i, cached, fresh);
+			assert(bitset_is_equal(fresh, cached));
+		}
+		FOR_EACH_SET_BIT(remaining, i)
+			assert(TEST_BIT(cached, i) || is_bitset_intersection_empty(split->graph[i], cached));
+	}
+	assert(condensation->splits->element_count == 20);
+	free_condensation(condensation);
+	free_bitset(fresh);
+	free_bitset(cached);
+	free_bitset(remaining);
+	free_argumentation_framework(split);
+	printf("cached splits: OK\n");
+
+	// the conflict framework from the blocked transpose
+	AF* conflicts = create_conflict_framework(af);
+	for (SIZE_TYPE i = 0; i < af->size; ++i)
+		for (SIZE_TYPE j = 0; j < af->size; ++j)
+			assert(!CHECK_ARG_ATTACKS_ARG(conflicts, i, j) ==
+					!(CHECK_ARG_ATTACKS_ARG(af, i, j) || CHECK_ARG_ATTACKS_ARG(af, j, i) ||
+					  CHECK_ARG_ATTACKS_ARG(af, i, i) || CHECK_ARG_ATTACKS_ARG(af, j, j)));
+	printf("conflicts: OK\n");
+
+	// the matrix products with the relations they stand for
+	AF* transpose = transpose_argumentation_framework(af);
+	AF* two_step = two_step_attack_framework(af);
+	AF* defends = defense_framework(af);
+	BitSet* victims = create_bitset(af->size);
+	for (SIZE_TYPE i = 0; i < af->size; ++i) {
+		get_victims(af, af->graph[i], victims);
+		assert(bitset_is_subset(victims, two_step->graph[i]) && bitset_is_subset(two_step->graph[i], victims));
+		for (SIZE_TYPE j = 0; j < af->size; ++j)
+			assert(!CHECK_ARG_ATTACKS_ARG(defends, i, j) == !bitset_is_subset(transpose->graph[j], af->graph[i]));
+	}
+	printf("matrix products: OK\n");
+
+	// the grounded extension on the lists and on the rows of a copy without
+	// them: the same complete extension, every argument that it defends is in
+	// it, and the defeated arguments are its victims
+	AF* rows_only = complement_argumentation_framework(af_c);
+	assert(HAS_ADJACENCY_LISTS(af) && !HAS_ADJACENCY_LISTS(rows_only));
+	BitSet* grounded = create_bitset(af->size);
+	BitSet* defeated = create_bitset(af->size);
+	BitSet* grounded_rows = create_bitset(af->size);
+	BitSet* defeated_rows = create_bitset(af->size);
+	grounded_extension(af, grounded, defeated);
+	grounded_extension(rows_only, grounded_rows, defeated_rows);
+	assert(bitset_is_equal(grounded, grounded_rows) && bitset_is_equal(defeated, defeated_rows));
+	get_victims(af, grounded, victims);
+	assert(bitset_is_equal(victims, defeated) && is_bitset_intersection_empty(grounded, defeated));
+	for (SIZE_TYPE i = 0; i < af->size; ++i)
+		assert(!TEST_BIT(grounded, i) == !bitset_is_subset(transpose->graph[i], defeated));
+	printf("grounded extension: OK\n");
+
+	// the weak components joined by the parser and found from the rows
+	build_weak_components(rows_only);
+	assert(af->component_of != NULL && af->component_count == rows_only->component_count);
+	for (SIZE_TYPE i = 0; i < af->size; ++i) {
+		assert(af->component_of[i] == rows_only->component_of[i] && af->component_of[i] <= i);
+		SIZE_TYPE j;
+		FOR_EACH_VICTIM(af, i, j)
+			assert(af->component_of[i] == af->component_of[j]);
+	}
+	printf("weak components: OK\n");
+
+	check_operators(af, 100);
+
+	// the compatible prefixes of random conflict-free sets, one after the
+	// other so that the levels are kept in between, against a scan of all
+	// arguments
+	AF* small = generate_framework(40, 8, NULL);
+	AF* small_t = transpose_argumentation_framework(small);
+	BitSet* excluded = create_bitset(small->size);
+	for (SIZE_TYPE i = 0; i < small->size; i += 7)
+		SET_BIT(excluded, i);
+	CompatiblePrefixes* prefixes = create_compatible_prefixes(small, excluded);
+	BitSet* s = create_bitset(small->size);
+	SIZE_TYPE elements[small->size];
+	for (int round = 0; round < 200; ++round) {
+		reset_bitset(s);
+		SIZE_TYPE count = 0;
+		for (SIZE_TYPE j = 0; j < small->size; ++j)
+			if (rand() % 3 == 0 && can_add_argument(small, small_t, s, j)) {
+				SET_BIT(s, j);
+				elements[count++] = j;
+			}
+		assert(update_compatible_prefixes(prefixes, small, small_t, s) == count);
+		for (SIZE_TYPE t = 0; t <= count; ++t) {
+			assert(t == count || prefixes->elements[t] == elements[t]);
+			for (SIZE_TYPE i = 0; i <= small->size; ++i) {
+				// the largest j below i after the first t elements that is in
+				// no conflict with them
+				SIZE_TYPE expected = small->size;
+				for (SIZE_TYPE j = (t > 0 ? elements[t - 1] + 1 : 0); j < i; ++j) {
+					bool compatible = !TEST_BIT(excluded, j) && !CHECK_ARG_ATTACKS_ARG(small, j, j);
+					for (SIZE_TYPE u = 0; u < t; ++u)
+						compatible = compatible && !CHECK_ARG_ATTACKS_ARG(small, j, elements[u]) &&
+									 !CHECK_ARG_ATTACKS_ARG(small, elements[u], j);
+					if (compatible)
+						expected = j;
+				}
+				assert(previous_compatible_argument(prefixes, t, i) == expected);
+			}
+		}
+	}
+	free_bitset(s);
+	free_bitset(excluded);
+	free_compatible_prefixes(prefixes);
+	free_argumentation_framework(small_t);
+	free_argumentation_framework(small);
+	printf("compatible prefixes: OK\n");
+
+	// the FCbO engine enumerates the extensions that Next-Closure finds
+	ListNode* (*fcbo_extensions[])(AF* af) = {ee_st_fcbo, ee_pr_fcbo, ee_co_fcbo};
+	ListNode* (*next_closure_extensions[])(AF* af) = {ee_st_next_closure, ee_pr_next_closure, ee_co_next_closure};
+	for (int s = 0; s < 3; ++s) {
+		ListNode* found = fcbo_extensions[s](af);
+		ListNode* reference = next_closure_extensions[s](af);
+		assert(is_same_extension_list(found, reference));
+		free_list(found, (void (*)(void *)) free_bitset);
+		free_list(reference, (void (*)(void *)) free_bitset);
+	}
+	printf("fcbo extensions: OK\n");
+
+	// more than two words of arguments: the operators on the tail of the
+	// last word, batches of candidates in every word, and a CbO root with more
+	// children than it keeps at a time, one for each argument divisible by
+	// three
+	AF* large = generate_framework(150, 0, cliques_and_chains);
+	check_operators(large, 100);
+	ListNode* found = ee_pr_plain_cbo(large, 0);
+	ListNode* reference = ee_pr_fcbo(large);
+	assert(is_same_extension_list(found, reference));
+	// suspended every few nodes and resumed, the search reports the same
+	size_t budgets[] = {1, 3, 7};
+	for (int b = 0; b < 3; ++b) {
+		ListNode* resumed = ee_pr_plain_cbo(large, budgets[b]);
+		assert(is_same_extension_list(resumed, found));
+		free_list(resumed, (void (*)(void *)) free_bitset);
+	}
+	SIZE_TYPE count = 0;
+	for (ListNode* node = found; node; node = node->next)
+		++count;
+	assert(count == 50);
+	free_list(found, (void (*)(void *)) free_bitset);
+	free_list(reference, (void (*)(void *)) free_bitset);
+	free_argumentation_framework(large);
+	large = generate_framework(150, 2, cliques_and_chains);
+	check_operators(large, 100);
+	free_argumentation_framework(large);
+	printf("large frameworks: OK\n");
+
+	// the operators and the Next-Closure solvers built for each width, at
+	// both ends of its sizes, and the generic ones above
+	// AF_FIXED_WIDTH_MAX_SIZE
+	SIZE_TYPE sizes[] = {1, 64, 65, 128, 129, 256, 257, 512, 513};
+	SIZE_TYPE widths[] = {1, 1, 2, 2, 4, 4, 8, 8, 0};
+	for (int k = 0; k < 9; ++k) {
+		large = generate_framework(sizes[k], 0, cliques_and_chains);
+		assert(af_fixed_width(large) == widths[k]);
+		check_operators(large, 10);
+		for (int s = 0; s < 2; ++s) {
+			found = next_closure_extensions[s](large);
+			reference = fcbo_extensions[s](large);
+			assert(is_same_extension_list(found, reference));
+			count = 0;
+			for (ListNode* node = found; node; node = node->next)
+				++count;
+			assert(count == (sizes[k] + 2) / 3);
+			free_list(found, (void (*)(void *)) free_bitset);
+			if (s == 0) {
+				// SE-ST finds one of the stable extensions
+				BitSet* stable = create_bitset(large->size);
+				se_st_next_closure(large, stable);
+				assert(list_contains(reference, stable));
+				free_bitset(stable);
+			}
+			free_list(reference, (void (*)(void *)) free_bitset);
+		}
+		free_argumentation_framework(large);
+	}
+	printf("fixed width solvers: OK\n");
+
 	return(0);
 }
 
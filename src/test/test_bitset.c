@@ -19,6 +19,8 @@
 #include <assert.h>
 
 #include "../bitset/bitset.h"
+#include "../bitset/bitset_arena.h"
+#include "../bitset/hybrid_set.h"
 
 int main(int argc, char *argv[]) {
 
@@ -71,5 +73,182 @@ int main(int argc, char *argv[]) {
 			printf("%d ",i);
 	printf("\n");
 
+	// compare the vectorized kernels with the scalar ones
+	printf("Default kernels: %s\n", bitset_kernels_name());
+	enum bitset_kernel_type default_kernels = bitset_kernels.type;
+	int sizes[] = {64, 250, 257, 511, 700, 1000};
+	for (int t = BITSET_KERNEL_SCALAR; t <= BITSET_KERNEL_AVX512; ++t) {
+		if (!select_bitset_kernels(t)) {
+			printf("Kernels %d not supported\n", t);
+			continue;
+		}
+		for (int s = 0; s < sizeof(sizes) / sizeof(int); ++s) {
+			BitSet* a = create_bitset(sizes[s]);
+			BitSet* b = create_bitset(sizes[s]);
+			BitSet* c = create_bitset(sizes[s]);
+			for (int k = 0; k < 100; ++k) {
+				reset_bitset(a);
+				reset_bitset(b);
+				for (i = 0; i < sizes[s]; ++i) {
+					if (rand() % 4 == 0)
+						SET_BIT(a, i);
+					if (rand() % 2 == 0 || (k % 2 && TEST_BIT(a, i)))
+						SET_BIT(b, i);
+				}
+				char subset = 1, empty = 1;
+				for (i = 0; i < sizes[s]; ++i) {
+					if (TEST_BIT(a, i) && !TEST_BIT(b, i))
+						subset = 0;
+					if (TEST_BIT(a, i) && TEST_BIT(b, i))
+						empty = 0;
+				}
+				assert(bitset_is_subset(a, b) == subset);
+				assert(is_bitset_intersection_empty(a, b) == empty);
+				bitset_intersection(a, b, c);
+				for (i = 0; i < sizes[s]; ++i)
+					assert(!TEST_BIT(c, i) == !(TEST_BIT(a, i) && TEST_BIT(b, i)));
+				bitset_union(a, b, c);
+				for (i = 0; i < sizes[s]; ++i)
+					assert(!TEST_BIT(c, i) == !(TEST_BIT(a, i) || TEST_BIT(b, i)));
+				bitset_set_minus(a, b, c);
+				for (i = 0; i < sizes[s]; ++i)
+					assert(!TEST_BIT(c, i) == !(TEST_BIT(a, i) && !TEST_BIT(b, i)));
+
+				// fused operations
+				int first = sizes[s], count = 0;
+				for (i = sizes[s] - 1; i >= 0; --i)
+					if (TEST_BIT(c, i)) {
+						first = i;
+						++count;
+					}
+				for (i = 0; i <= sizes[s]; i += 7)
+					assert(bitset_set_minus_is_empty_below(a, b, i) == (first >= i));
+				assert(count_bits_set_minus(a, b) == count);
+
+				// set bit iteration
+				assert(count_bits(c) == count);
+				assert(bitset_next_set_minus_bit(a, b, 0) == first);
+				SIZE_TYPE j, last = sizes[s], n = 0;
+				FOR_EACH_SET_BIT(c, j) {
+					assert(TEST_BIT(c, j));
+					assert(bitset_next_set_minus_bit(a, b, last == sizes[s] ? 0 : last + 1) == j);
+					last = j;
+					++n;
+				}
+				assert(n == count);
+				if (count > 0)
+					assert(bitset_prev_set_bit(c, sizes[s] - 1) == last);
+				for (i = 0; i < sizes[s]; i += 5) {
+					j = bitset_next_clear_bit(a, i);
+					assert(j == sizes[s] || !TEST_BIT(a, j));
+					while (--j >= i && j < sizes[s])
+						assert(TEST_BIT(a, j));
+				}
+				assert(bitset_is_fullset(c) == (count == sizes[s]));
+				assert(bitset_is_intersection_subset(a, b, a));
+				assert(bitset_is_intersection_subset(a, b, b));
+				assert(bitset_is_intersection_subset(a, b, c) == empty);
+				bitset_intersection(a, b, c);
+				assert(bitset_is_intersection_equal(a, b, c));
+				assert(bitset_intersection_is_empty(a, b, c) == empty);
+				set_bitset(c);
+				assert(bitset_is_fullset(c) && count_bits(c) == sizes[s]);
+				assert(bitset_next_clear_bit(c, 0) == sizes[s]);
+			}
+			free_bitset(a);
+			free_bitset(b);
+			free_bitset(c);
+		}
+		// blocked transpose of a strip of 11 blocks, with a short strip
+		for (SIZE_TYPE rows = 37; rows <= BITSET_BASE_SIZE; rows += BITSET_BASE_SIZE - 37) {
+			SIZE_TYPE count = 11, stride = 13;
+			BITSET_BASE_TYPE src[BITSET_BASE_SIZE * 13], dst[BITSET_BASE_SIZE * 11];
+			for (i = 0; i < BITSET_BASE_SIZE * stride; ++i)
+				src[i] = ((BITSET_BASE_TYPE) rand() << 32) ^ rand();
+			bitset_kernels.transpose_blocks(src, stride, rows, dst, count);
+			for (SIZE_TYPE r = 0; r < BITSET_BASE_SIZE; ++r)
+				for (SIZE_TYPE c = 0; c < count * BITSET_BASE_SIZE; ++c) {
+					char bit = r < rows && (src[r * stride + c / BITSET_BASE_SIZE] >> (c % BITSET_BASE_SIZE)) & 1;
+					assert(((dst[c] >> r) & 1) == bit);
+				}
+		}
+		printf("Kernels %s: OK\n", bitset_kernels_name());
+	}
+	select_bitset_kernels(default_kernels);
+
+	// arena: bitsets are handed out empty and reused after release
+	BitSetArena* arena = create_bitset_arena(300);
+	size_t mark = bitset_arena_mark(arena);
+	BitSet* first = bitset_arena_alloc(arena);
+	for (i = 0; i < 3 * BITSET_ARENA_CHUNK_SIZE; ++i) {
+		BitSet* t = bitset_arena_alloc(arena);
+		assert(t->size == 300 && bitset_is_emptyset(t));
+		set_bitset(t);
+	}
+	set_bitset(first);
+	bitset_arena_release(arena, mark);
+	assert(bitset_arena_alloc(arena) == first);
+	assert(bitset_is_emptyset(first));
+	free_bitset_arena(arena);
+	printf("Arena: OK\n");
+
+	// hybrid set: same answers before and after the switch to a bitmap
+	HybridSet* hs = create_hybrid_set(1000, 2);
+	BitSet* ref = create_bitset(1000);
+	for (i = 0; i < 200; ++i) {
+		SIZE_TYPE k = rand() % 1000;
+		hybrid_set_add(hs, k);
+		SET_BIT(ref, k);
+		assert(hs->count == count_bits(ref));
+		SIZE_TYPE j, n = 0;
+		FOR_EACH_HYBRID_SET_ELEMENT(hs, j) {
+			assert(TEST_BIT(ref, j));
+			++n;
+		}
+		assert(n == hs->count);
+		assert(hybrid_set_contains(hs, k));
+	}
+	assert(hs->type == HYBRID_SET_BITMAP);
+	BitSet* u = create_bitset(1000);
+	hybrid_set_union_into(hs, u);
+	assert(bitset_is_subset(u, ref) && bitset_is_subset(ref, u));
+	free_hybrid_set(hs);
+	free_bitset(u);
+	free_bitset(ref);
+
+	// sets stored as an array, a bitmap or runs, and elements added to runs
+	for (int k = 0; k < 300; ++k) {
+		HybridSet* h = create_hybrid_set(1000, 0);
+		BitSet* r = create_bitset(1000);
+		int count = k % 3 == 0 ? 300 : rand() % 25;
+		for (int e = 0; e < count; ++e) {
+			// intervals for the runs
+			SIZE_TYPE first = rand() % 1000, length = k % 2 ? rand() % 80 + 1 : 1;
+			for (SIZE_TYPE j = first; j < first + length && j < 1000; ++j) {
+				hybrid_set_add(h, j);
+				SET_BIT(r, j);
+			}
+		}
+		for (int step = 0; step < 2; ++step) {
+			if (k % 4)
+				hybrid_set_optimize(h);
+			BitSet* found = create_bitset(1000);
+			hybrid_set_union_into(h, found);
+			assert(bitset_is_equal(found, r) && h->count == count_bits(r));
+			SIZE_TYPE j, n = 0;
+			FOR_EACH_HYBRID_SET_ELEMENT(h, j) {
+				assert(TEST_BIT(r, j) && hybrid_set_contains(h, j));
+				++n;
+			}
+			assert(n == count_bits(r));
+			free_bitset(found);
+			hybrid_set_add(h, k);
+			SET_BIT(r, k);
+		}
+		free_hybrid_set(h);
+		free_bitset(r);
+	}
+	printf("Hybrid set: OK\n");
+
 	return(0);
 }
@@ -27,7 +27,7 @@
 
 #define MAP_INITIAL_SIZE 	100
 #define SET_INITIAL_SIZE 	100
-#define BITSET_SIZE			20
+#define BITSET_SIZE			200
 
 int main(int argc, char *argv[]) {
 
@@ -0,0 +1,304 @@
+/*
+ * AFCA - argumentation framework using closed sets
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "../parser/af_parser.h"
+#include "../af/af.h"
+#include "../algorithms/dc.h"
+#include "../algorithms/grounded_reduct.h"
+#include "../algorithms/cbo/preferred.h"
+#include "../algorithms/connected-components/scc.h"
+#include "../algorithms/connected-components/wcc.h"
+#include "../algorithms/fcbo/fcbo.h"
+#include "../algorithms/ideal/ideal.h"
+#include "../algorithms/maximal-independent-sets/mis.h"
+#include "../algorithms/next-closure/stable.h"
+#include "../algorithms/next-closure/preferred.h"
+#include "../algorithms/next-closure/complete.h"
+#include "../algorithms/norris/stable.h"
+#include "../algorithms/nourine/stable.h"
+#include "generate_af.h"
+
+// The solvers that affca runs on the reduct of a framework by its grounded
+// extension (returns_extensions) give the extensions of the framework once
+// the grounded extension is added back. Each of them is checked here, against
+// a reference solver run on the whole framework.
+
+// The first few arguments are unattacked, so that the grounded extension of
+// the framework is not empty.
+int unattacked_prefix(SIZE_TYPE size, SIZE_TYPE i, SIZE_TYPE j, int density) {
+	return(j < size / 8 ? 0 : density);
+}
+
+bool list_contains(ListNode* node, BitSet* bs) {
+	for (; node; node = node->next)
+		if (bitset_is_equal(node->c, bs))
+			return(true);
+	return(false);
+}
+
+SIZE_TYPE list_length(ListNode* node) {
+	SIZE_TYPE n = 0;
+	for (; node; node = node->next)
+		++n;
+	return(n);
+}
+
+bool list_has_argument(ListNode* node, SIZE_TYPE argument) {
+	for (; node; node = node->next)
+		if (TEST_BIT(((BitSet*) node->c), argument))
+			return(true);
+	return(false);
+}
+
+typedef ListNode* (*Extensions)(AF* af);
+
+// as in affca
+ListNode* ee_pr_scc_next_closure(AF* af) {
+	return(ee_pr_scc(af, ee_pr_next_closure));
+}
+
+// An enumeration solver of affca, run on its own or on each component
+struct enumeration {
+	enum prob_type prob;
+	enum alg_type alg;
+	ListNode* (*components)(AF* af, Extensions extensions);
+	Extensions extensions;
+};
+
+struct enumeration enumerations[] = {
+	{EE_ST, FCBO, NULL, ee_st_fcbo},
+	{EE_ST, MIS, NULL, ee_st_maximal_independent_sets},
+	{EE_ST, NEXT_CLOSURE, NULL, ee_st_next_closure},
+	{EE_ST, NORRIS, NULL, ee_st_norris},
+	{EE_ST, NORRIS_BU, NULL, enumerate_stable_extensions_norris_bottom_up},
+	{EE_ST, NOURINE, NULL, ee_st_nourine},
+	{EE_ST, SCC_MIS, scc_stable_extensions, ee_st_maximal_independent_sets},
+	{EE_ST, WCC_MIS, wcc_stable_extensions, ee_st_maximal_independent_sets},
+	{EE_ST, SCC_NEXT_CLOSURE, scc_stable_extensions, ee_st_next_closure},
+	{EE_ST, SCC_NORRIS, scc_stable_extensions, ee_st_norris},
+	{EE_ST, WCC_NORRIS, wcc_stable_extensions, ee_st_norris},
+	{EE_ST, SCC_NORRIS_BU, scc_stable_extensions, enumerate_stable_extensions_norris_bottom_up},
+	{EE_ST, SCC_NOURINE, scc_stable_extensions, enumerate_stable_extensions_via_implications},
+	{EE_ST, WCC_NOURINE, wcc_stable_extensions, enumerate_stable_extensions_via_implications},
+	{EE_PR, CBO, NULL, ee_pr_cbo},
+	{EE_PR, FCBO, NULL, ee_pr_fcbo},
+	{EE_PR, NEXT_CLOSURE, NULL, ee_pr_next_closure},
+	{EE_PR, SCC_CBO, ee_pr_scc, ee_pr_cbo},
+	{EE_PR, SCC_NEXT_CLOSURE, ee_pr_scc, ee_pr_next_closure},
+	{EE_CO, FCBO, NULL, ee_co_fcbo},
+	{EE_CO, NEXT_CLOSURE, NULL, ee_co_next_closure},
+};
+
+#define ENUMERATION_COUNT (sizeof(enumerations) / sizeof(enumerations[0]))
+
+// The combinations with a single extension or witness, checked one by one in
+// main
+#define SINGLE_COUNT 14
+
+ListNode* run_enumeration(struct enumeration* e, AF* af) {
+	return(e->components ? e->components(af, e->extensions) : e->extensions(af));
+}
+
+// the extensions of the reduct lifted are the expected ones of af
+void check_enumeration(struct enumeration* e, PAF* reduct, BitSet* grounded, ListNode* expected) {
+	assert(returns_extensions(e->prob, e->alg));
+	ListNode* reduced = run_enumeration(e, reduct->af);
+	assert(list_length(expected) == list_length(reduced));
+	lift_extensions(reduced, reduct, grounded);
+	for (ListNode* node = reduced; node; node = node->next)
+		assert(list_contains(expected, node->c));
+	free_list(reduced, (void (*)(void *)) free_bitset);
+}
+
+// a single extension of the reduct lifted is one of the expected extensions
+// of af, an empty result is no extension since the reduct is not empty
+void check_single(PAF* reduct, BitSet* grounded, BitSet* extension, ListNode* expected) {
+	if (!extension || bitset_is_emptyset(extension)) {
+		assert(expected == NULL);
+		if (extension)
+			free_bitset(extension);
+		return;
+	}
+	BitSet* lifted = lift_extension(extension, reduct, grounded);
+	assert(list_contains(expected, lifted));
+	free_bitset(lifted);
+}
+
+// a witness of the reduct for an argument of af, lifted, is one of the
+// expected extensions of af with the argument, or there is none
+void check_witness(PAF* reduct, BitSet* grounded, BitSet* witness, SIZE_TYPE argument, ListNode* expected) {
+	if (!witness || bitset_is_emptyset(witness)) {
+		assert(!list_has_argument(expected, argument));
+		if (witness)
+			free_bitset(witness);
+		return;
+	}
+	BitSet* lifted = lift_witness(witness, reduct, grounded, argument);
+	assert(list_contains(expected, lifted));
+	free_bitset(lifted);
+}
+
+// every combination affca reduces is checked
+void check_coverage() {
+	SIZE_TYPE reduced = 0;
+	for (int prob = EE_ST; prob <= DC_GR; ++prob)
+		for (int alg = CBO; alg < NO_ALGORITHM; ++alg)
+			reduced += returns_extensions(prob, alg);
+	assert(reduced == ENUMERATION_COUNT + SINGLE_COUNT);
+}
+
+int main(int argc, char *argv[]) {
+	check_coverage();
+
+	SIZE_TYPE reducts = 0;
+	for (int k = 0; reducts < 200; ++k) {
+		SIZE_TYPE size = 4 + k % 17;
+		AF* af = generate_framework(size, 5 + k % 4 * 5, unattacked_prefix);
+
+		BitSet* grounded = create_bitset(af->size);
+		BitSet* undecided = create_bitset(af->size);
+		grounded_extension(af, grounded, undecided);
+		bitset_union(undecided, grounded, undecided);
+		complement_bitset(undecided, undecided);
+		SIZE_TYPE undecided_count = count_bits(undecided);
+		if (undecided_count == 0 || undecided_count == af->size) {
+			free_bitset(grounded);
+			free_bitset(undecided);
+			free_argumentation_framework(af);
+			continue;
+		}
+		++reducts;
+		PAF* reduct = project_argumentation_framework(af, undecided);
+
+		ListNode* stable = ee_st_fcbo(af);
+		ListNode* preferred = ee_pr_cbo(af);
+		ListNode* complete = ee_co_fcbo(af);
+		for (SIZE_TYPE e = 0; e < ENUMERATION_COUNT; ++e) {
+			enum prob_type prob = enumerations[e].prob;
+			check_enumeration(&enumerations[e], reduct, grounded, prob == EE_ST ? stable : prob == EE_PR ? preferred : complete);
+		}
+
+		// SE-ST: fcbo, mis, next-closure and nourine
+		BitSet* result;
+		result = create_bitset(reduct->af->size);
+		se_st_fcbo(reduct->af, result);
+		check_single(reduct, grounded, result, stable);
+		check_single(reduct, grounded, se_st_mis(reduct->af), stable);
+		result = create_bitset(reduct->af->size);
+		se_st_next_closure(reduct->af, result);
+		check_single(reduct, grounded, result, stable);
+		result = create_bitset(reduct->af->size);
+		se_st_nourine(reduct->af, result);
+		check_single(reduct, grounded, result, stable);
+
+		// a preferred extension always exists, it may be empty on the reduct
+		result = se_pr_cbo(reduct->af);
+		BitSet* lifted = lift_extension(result, reduct, grounded);
+		assert(list_contains(preferred, lifted));
+		free_bitset(lifted);
+
+		// SE-ID: next-closure and scc-next-closure
+		BitSet* ideal = se_id(af, ee_pr_next_closure);
+		lifted = lift_extension(se_id(reduct->af, ee_pr_next_closure), reduct, grounded);
+		assert(bitset_is_equal(ideal, lifted));
+		free_bitset(lifted);
+		lifted = lift_extension(se_id(reduct->af, ee_pr_scc_next_closure), reduct, grounded);
+		assert(bitset_is_equal(ideal, lifted));
+		free_bitset(lifted);
+		free_bitset(ideal);
+
+		// the undecided arguments are renumbered by their rank in the reduct,
+		// a witness of DC-PR is an admissible set with the argument
+		AF* attacked_by = get_transpose_framework(af);
+		BitSet* up = create_bitset(af->size);
+		BitSet* down = create_bitset(af->size);
+		SIZE_TYPE i, rank = 0;
+		FOR_EACH_SET_BIT(undecided, i) {
+			// DC-ST: mis and next-closure
+			check_witness(reduct, grounded, dc(reduct->af, rank, se_st_mis), i, stable);
+			result = create_bitset(reduct->af->size);
+			dc_st_next_closure(reduct->af, rank, result);
+			check_witness(reduct, grounded, result, i, stable);
+
+			// DC-CO: next-closure, subgraph and subgraph-adj
+			check_witness(reduct, grounded, dc_co_next_closure_2(reduct->af, rank), i, complete);
+			check_witness(reduct, grounded, dc_co_subgraph_next_closure(reduct->af, rank), i, complete);
+			check_witness(reduct, grounded, dc_co_subgraph_next_closure_adj(reduct->af, rank), i, complete);
+
+			BitSet* expected = dc_pr_cbo_smart(af, i);
+			result = dc_pr_cbo_smart(reduct->af, rank);
+			assert(!expected == !result);
+			if (result) {
+				lifted = lift_witness(result, reduct, grounded, i);
+				assert(is_set_conflict_free(af, lifted) &&
+					   is_conflict_free_set_admissible(lifted, af, attacked_by, up, down));
+				free_bitset(expected);
+				free_bitset(lifted);
+			}
+			expected = ds_pr_cbo(af, i);
+			result = ds_pr_cbo(reduct->af, rank);
+			assert(!expected == !result);
+			if (result) {
+				free_bitset(expected);
+				free_bitset(result);
+			}
+			++rank;
+		}
+
+		// The decided arguments are answered by the grounded extension. For
+		// DC-ST on an accepted argument any stable extension of the reduct,
+		// lifted, is a witness.
+		FOR_EACH_SET_BIT(grounded, i) {
+			assert(grounded_answer(DC_CO, grounded, i) == grounded && list_contains(complete, grounded));
+			assert(grounded_answer(DC_PR, grounded, i) == grounded);
+			assert(grounded_answer(DS_PR, grounded, i) == NULL && !ds_pr_cbo(af, i));
+			check_witness(reduct, grounded, se_st_mis(reduct->af), i, stable);
+			result = create_bitset(reduct->af->size);
+			se_st_next_closure(reduct->af, result);
+			check_witness(reduct, grounded, result, i, stable);
+		}
+		BitSet* defeated = create_bitset(af->size);
+		bitset_union(grounded, undecided, defeated);
+		complement_bitset(defeated, defeated);
+		FOR_EACH_SET_BIT(defeated, i) {
+			assert(grounded_answer(DC_ST, grounded, i) == NULL && !list_has_argument(stable, i));
+			assert(grounded_answer(DC_CO, grounded, i) == NULL && !list_has_argument(complete, i));
+			assert(grounded_answer(DC_PR, grounded, i) == NULL && !list_has_argument(preferred, i));
+			// the grounded extension attacks the argument and is admissible
+			assert(grounded_answer(DS_PR, grounded, i) == grounded);
+			assert(is_conflict_free_set_admissible(grounded, af, attacked_by, up, down));
+		}
+		free_bitset(defeated);
+		release_derived_framework(attacked_by);
+		free_bitset(up);
+		free_bitset(down);
+		free_list(stable, (void (*)(void *)) free_bitset);
+		free_list(preferred, (void (*)(void *)) free_bitset);
+		free_list(complete, (void (*)(void *)) free_bitset);
+
+		free_projected_argumentation_framework(reduct);
+		free_bitset(grounded);
+		free_bitset(undecided);
+		free_argumentation_framework(af);
+	}
+	printf("grounded reducts: OK\n");
+
+	return(0);
+}
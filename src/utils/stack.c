@@ -21,9 +21,11 @@
 
 extern inline void push(Stack*s, unsigned int e);
 extern inline unsigned int pop(Stack* s);
+extern inline void free_stack(Stack* s);
 
 void init_stack(Stack* s) {
 	s->size = 0;
+	s->capacity = 0;
 	s->elements = NULL;
 }
 
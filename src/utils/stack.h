@@ -32,6 +32,8 @@ union stack_element {
 
 struct stack {
 	int size;
+	// number of elements there is space for, doubled when full
+	int capacity;
 	unsigned int* elements;
 	// StackElement** elements;
 };
@@ -39,27 +41,23 @@ struct stack {
 void init_stack(Stack* s);
 
 inline void push(Stack* s, unsigned int e) {
-	unsigned int* tmp = realloc(s->elements, (s->size + 1) * sizeof(unsigned int));
-	assert(tmp != NULL);
-	s->elements = tmp;
+	if (s->size == s->capacity) {
+		s->capacity = s->capacity ? 2 * s->capacity : 16;
+		unsigned int* tmp = realloc(s->elements, s->capacity * sizeof(unsigned int));
+		assert(tmp != NULL);
+		s->elements = tmp;
+	}
 	s->elements[s->size] = e;
 	++s->size;
 }
 
+// the space is kept for the next push
 inline unsigned int pop(Stack* s) {
-	unsigned int e;
-	unsigned int* tmp;
-
 	if (s->size == 0)
 		return(-1);
 
 	--s->size;
-	e = s->elements[s->size];
-	tmp = realloc(s->elements, (s->size) * sizeof(unsigned int));
-	assert(tmp != NULL || s->size == 0);
-	s->elements = tmp;
-
-	return e;
+	return s->elements[s->size];
 }
 
 inline void free_stack(Stack* s) {